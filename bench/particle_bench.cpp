@@ -0,0 +1,115 @@
+/**
+ * @file particle_bench.cpp
+ *
+ * @brief particle system benchmark, system is kept full and updated with fixed time step
+ * on calling thread, update includes integration, compaction and quad build
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "particles.hpp"
+
+/////////////////////////////BENCHMARK SETTINGS/////////////////////////////////
+//live particles that shall be updated within one frame
+constexpr std::size_t      default_bench_particles = 100000;
+//measured frames after warm-up
+constexpr unsigned int     default_bench_frames    = 600;
+//frames before measurement, particles reach steady mix of ages
+constexpr unsigned int     bench_warmup_frames     = 120;
+//frame period and budget
+constexpr unsigned int     bench_framerate         = 60;
+//particles of one burst, same as player explosion
+constexpr std::size_t      bench_burst             = 256;
+//burst centers are spread over game field
+constexpr float            bench_field_size        = 1000.f;
+////////////////////////////////////////////////////////////////////////////////
+
+struct BenchResult
+{
+    /// @brief number of measured frames
+    unsigned int frames = 0;
+    /// @brief time spent refilling the system
+    std::chrono::steady_clock::duration emit = std::chrono::steady_clock::duration::zero();
+    /// @brief time spent in update, integration, compaction and quad build
+    std::chrono::steady_clock::duration update = std::chrono::steady_clock::duration::zero();
+    /// @brief slowest update
+    std::chrono::steady_clock::duration worst = std::chrono::steady_clock::duration::zero();
+    /// @brief sum of live particles after every update
+    std::uint64_t particles = 0;
+    /// @brief fewest live particles after update
+    std::size_t min_particles = 0;
+};
+
+/// @brief emit bursts until system is full
+static void refill(si::ParticleSystem& particles, std::size_t capacity, std::minstd_rand& randomizer)
+{
+    static const std::array<sf::Color,3> colors = {sf::Color::Green, sf::Color::Red, sf::Color::Yellow};
+    std::uniform_real_distribution<float> coordinate(0.f,bench_field_size);
+    while(particles.getSize() < capacity)
+    {
+        const auto count = std::min(bench_burst,capacity - particles.getSize());
+        particles.emit(sf::Vector2f(coordinate(randomizer),coordinate(randomizer)),count,colors[randomizer() % colors.size()]);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using clock = std::chrono::steady_clock;
+    using std::chrono::duration;
+    std::size_t capacity = default_bench_particles;
+    unsigned int frames  = default_bench_frames;
+    auto next_argument   = [&](int& i){return (i + 1 < argc) ? argv[++i] : "0";};
+    for(auto i = 1; i < argc; ++i)
+    {
+        //number of live particles
+        if(std::strcmp(argv[i],"--particles") == 0){capacity = static_cast<std::size_t>(std::strtoull(next_argument(i),nullptr,10));}
+        //number of measured frames
+        else if(std::strcmp(argv[i],"--frames") == 0){frames = static_cast<unsigned int>(std::strtoul(next_argument(i),nullptr,10));}
+    }
+    capacity = std::max<std::size_t>(capacity,1);
+    frames   = std::max(frames,1u);
+
+    constexpr float dt = 1.f/bench_framerate;
+    si::ParticleSystem particles(capacity);
+    std::minstd_rand randomizer(1);
+    BenchResult result;
+    result.min_particles = capacity;
+    for(unsigned int frame = 0; frame < bench_warmup_frames + frames; ++frame)
+    {
+        //dead particles are replaced every frame, so every update runs on a full system
+        const auto emit_start = clock::now();
+        refill(particles,capacity,randomizer);
+        const auto update_start = clock::now();
+        particles.update(dt);
+        const auto update_end = clock::now();
+        if(frame < bench_warmup_frames){continue;}
+        ++result.frames;
+        result.emit         += update_start - emit_start;
+        result.update       += update_end - update_start;
+        result.worst         = std::max(result.worst,update_end - update_start);
+        result.particles    += particles.getSize();
+        result.min_particles = std::min(result.min_particles,particles.getSize());
+    }
+
+    const double budget_us = 1e6/bench_framerate;
+    const double update_us = duration<double,std::micro>(result.update).count()/result.frames;
+    const double worst_us  = duration<double,std::micro>(result.worst).count();
+    std::cout<<"particle benchmark: "<<capacity<<" particles, "<<frames<<" frames, "<<bench_framerate<<" Hz budget "
+             <<static_cast<unsigned long long>(budget_us)<<" us\n"
+             <<"update (integrate, compact, quads): "<<static_cast<unsigned long long>(update_us)<<" us/frame"
+             <<", worst "<<static_cast<unsigned long long>(worst_us)<<" us"
+             <<", "<<static_cast<unsigned long long>(update_us*100.0/budget_us)<<"% of budget\n"
+             <<"refill emit: "<<static_cast<unsigned long long>(duration<double,std::micro>(result.emit).count()/result.frames)<<" us/frame\n"
+             <<"live particles after update: average "<<result.particles/result.frames<<", min "<<result.min_particles<<"\n"
+             <<((worst_us <= budget_us) ? "every update fits into one frame\n" : "updates run over frame budget\n");
+    return 0;
+}
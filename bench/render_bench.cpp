@@ -0,0 +1,234 @@
+/**
+ * @file render_bench.cpp
+ *
+ * @brief offscreen render throughput benchmark, game items and HUD are drawn to sf::RenderTexture
+ * without vsync and frame limit
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <SFML/OpenGL.hpp>
+#include "autopilot.hpp"
+#include "canvas.hpp"
+#include "headless.hpp"
+#include "scene.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/////////////////////////////BENCHMARK SETTINGS/////////////////////////////////
+//rendered frames of every layout
+constexpr unsigned int     default_bench_frames = 2000;
+//simulated ticks before rendering, autopilot fills the field with shells and debris
+constexpr unsigned int     default_bench_warmup = 1200;
+//autopilot never dodges and fires constantly
+constexpr float            bench_aggression     = 1.f;
+//same workload in every run
+constexpr std::uint32_t    bench_seed           = 1;
+////////////////////////////////////////////////////////////////////////////////
+
+struct BenchResources
+{
+    /// @brief texture with player image
+    sf::Texture player;
+    /// @brief textures of invader rows
+    std::array<sf::Texture,3> enemies;
+    /// @brief texture with enemy ship
+    sf::Texture enemy_ship;
+    /// @brief texture for shells, obstacles and canvas frames, not loaded like in canvas
+    sf::Texture blank;
+    /// @brief font for score text
+    sf::Font font;
+};
+
+struct BenchResult
+{
+    /// @brief statistics of last submission, scene is the same in every frame
+    si::RenderStatistics statistics;
+    /// @brief number of rendered frames
+    unsigned int frames = 0;
+    /// @brief wall time of all frames
+    std::chrono::steady_clock::duration wall = std::chrono::steady_clock::duration::zero();
+    /// @brief wall time spent in SFML clear, draw and display calls
+    std::chrono::steady_clock::duration sfml_wall = std::chrono::steady_clock::duration::zero();
+    /// @brief CPU time of the rendering thread spent in SFML clear, draw and display calls
+    std::chrono::nanoseconds sfml_cpu = std::chrono::nanoseconds::zero();
+    /// @brief CPU time of all threads of the process during all frames, includes software
+    /// rasterizer and driver threads
+    std::chrono::nanoseconds process_cpu = std::chrono::nanoseconds::zero();
+};
+
+enum class CpuClock
+{
+    /// @brief calling thread only
+    Thread,
+    /// @brief all threads of the process
+    Process
+};
+
+/// @brief get consumed CPU time, user and kernel time are summed, std::clock is not used
+/// because it measures wall time on MSVC
+static std::chrono::nanoseconds getCpuTime(CpuClock cpu_clock)
+{
+#ifdef _WIN32
+    FILETIME creation, exit_time, kernel, user;
+    const BOOL valid = (cpu_clock == CpuClock::Thread) ? GetThreadTimes(GetCurrentThread(),&creation,&exit_time,&kernel,&user)
+                                                       : GetProcessTimes(GetCurrentProcess(),&creation,&exit_time,&kernel,&user);
+    if(!valid){return std::chrono::nanoseconds::zero();}
+    //file time counts 100 ns intervals
+    auto toTicks = [](const FILETIME& time){return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;};
+    return std::chrono::nanoseconds((toTicks(kernel) + toTicks(user))*100);
+#else
+    timespec time{};
+    clock_gettime((cpu_clock == CpuClock::Thread) ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID,&time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#endif
+}
+
+static void loadTexture(sf::Texture& texture, const std::string& path)
+{
+    if(!texture.loadFromFile(path))
+    {
+        throw std::runtime_error(std::string("Could not load resource files!"));
+    }
+    texture.setSmooth(true);
+}
+
+//same textures as in Canvas::setupTextures, rectangles and masks are set by headless setup,
+//explosion particles are rendered like in canvas
+template<class GameType>
+static void setupBenchTextures(GameType& game, BenchResources& resources)
+{
+    si::setupHeadlessItems(game);
+    game.setEffects(true);
+    int num_of_invaders = game.enemies.size();
+    for(auto i = 0; i < num_of_invaders; ++i)
+    {
+        game.enemies[i].setTexture(resources.enemies[(i/GameType::config_type::invaders_in_row) % resources.enemies.size()]);
+    }
+    for(Obstacle& obstacle : game.obstacles){obstacle.setTexture(resources.blank);}
+    game.player->setTexture(resources.player);
+    game.invader_ship->setTexture(resources.enemy_ship);
+    game.bullets[0].setTexture(resources.blank);
+    game.bullets[0].setSpriteColor(sf::Color(40, 236, 250));
+}
+
+template<class GameType>
+static BenchResult renderLayout(sf::RenderTexture& target, BenchResources& resources, unsigned int warmup, unsigned int frames)
+{
+    using clock = std::chrono::steady_clock;
+    GameType game;
+    setupBenchTextures(game,resources);
+    game.setSeed(bench_seed);
+    si::Autopilot autopilot(bench_aggression);
+    //first autopilot tick starts the game
+    for(unsigned int tick = 0; tick <= warmup; ++tick)
+    {
+        autopilot.drive(game);
+        if(game.status == si::GameStatus::Running){game.gameLoop();}
+        game.events.drain([](const si::GameEvent&){});
+        game.arena.reset();
+    }
+    //same HUD as in Canvas::updateCanvas
+    si::HudSprites hud;
+    si::setupHud(hud,resources.font,font_size,resources.player,resources.blank);
+    hud.score.setString("SCORE: " + std::to_string(game.elements.score));
+    si::RenderQueue queue;
+    si::SfmlBackend backend(target);
+    BenchResult result;
+    const auto cpu_start  = getCpuTime(CpuClock::Process);
+    const auto wall_start = clock::now();
+    for(unsigned int frame = 0; frame < frames; ++frame)
+    {
+        queue.clear();
+        si::recordHud(queue,hud,game.elements.player_lives);
+        si::recordGameItems(queue,game);
+        queue.sort();
+        const auto sfml_start     = clock::now();
+        const auto sfml_cpu_start = getCpuTime(CpuClock::Thread);
+        target.clear(sf::Color::Black);
+        backend.submit(queue);
+        target.display();
+        result.sfml_cpu  += getCpuTime(CpuClock::Thread) - sfml_cpu_start;
+        result.sfml_wall += clock::now() - sfml_start;
+    }
+    //queued commands are finished before time is taken
+    glFinish();
+    result.wall        = clock::now() - wall_start;
+    result.process_cpu = getCpuTime(CpuClock::Process) - cpu_start;
+    result.frames      = frames;
+    result.statistics  = backend.getStatistics();
+    return result;
+}
+
+static void printResult(const char* layout, const BenchResult& result, std::ostream& stream)
+{
+    using std::chrono::duration;
+    auto perFrame = [&result](auto time){return static_cast<unsigned long long>(duration<double,std::micro>(time).count()/result.frames);};
+    const double wall_s = duration<double>(result.wall).count();
+    stream<<layout<<": "
+          <<static_cast<unsigned long long>(result.frames/wall_s)<<" fps"
+          <<", commands "<<result.statistics.commands
+          <<", draw calls "<<result.statistics.draw_calls
+          <<", texture changes "<<result.statistics.texture_changes
+          <<", sfml wall "<<perFrame(result.sfml_wall)<<" us/frame"
+          <<", sfml thread cpu "<<perFrame(result.sfml_cpu)<<" us/frame"
+          <<", process cpu (all threads) "<<perFrame(result.process_cpu)<<" us/frame\n";
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int frames = default_bench_frames;
+    unsigned int warmup = default_bench_warmup;
+    auto next_argument  = [&](int& i){return (i + 1 < argc) ? argv[++i] : "0";};
+    for(auto i = 1; i < argc; ++i)
+    {
+        //number of rendered frames of every layout
+        if(std::strcmp(argv[i],"--frames") == 0){frames = static_cast<unsigned int>(std::strtoul(next_argument(i),nullptr,10));}
+        //number of simulated ticks before rendering
+        else if(std::strcmp(argv[i],"--warmup") == 0){warmup = static_cast<unsigned int>(std::strtoul(next_argument(i),nullptr,10));}
+    }
+    frames = std::max(frames,1u);
+
+    //same target size and view as the game window
+    sf::RenderTexture target;
+    if(!target.create(canvas_width,canvas_height))
+    {
+        throw std::runtime_error(std::string("Could not create render texture!"));
+    }
+    target.setView(sf::View(sf::FloatRect(si::default_start_x, si::default_start_y, si::default_x_size, si::default_y_size)));
+    target.setActive(true);
+
+    BenchResources resources;
+    loadTexture(resources.enemies[0],"rc/textures/green.png");
+    loadTexture(resources.enemies[1],"rc/textures/red.png");
+    loadTexture(resources.enemies[2],"rc/textures/yellow.png");
+    loadTexture(resources.player,"rc/textures/player.png");
+    loadTexture(resources.enemy_ship,"rc/textures/extra.png");
+    if(!resources.font.loadFromFile("rc/fonts/SpaceMission.ttf"))
+    {
+        throw std::runtime_error(std::string("Could not load resource files!"));
+    }
+
+    std::cout<<"render benchmark: "<<canvas_width<<"x"<<canvas_height<<", "<<frames<<" frames, warm-up "<<warmup<<" ticks, renderer "
+             <<reinterpret_cast<const char*>(glGetString(GL_RENDERER))<<"\n";
+    printResult("classic first wave",renderLayout<si::Game>(target,resources,0,frames),std::cout);
+    printResult("classic battle",renderLayout<si::Game>(target,resources,warmup,frames),std::cout);
+    printResult("stress first wave",renderLayout<si::StressGame>(target,resources,0,frames),std::cout);
+    printResult("stress battle",renderLayout<si::StressGame>(target,resources,warmup,frames),std::cout);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file alloc.hpp
+ *
+ * @brief opt-in global allocation tracking by frame stages
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace si
+{
+    //global operator new and delete are replaced only in builds with SI_ALLOCATION_TRACKING
+#ifdef SI_ALLOCATION_TRACKING
+    constexpr bool allocation_tracking = true;
+#else
+    constexpr bool allocation_tracking = false;
+#endif
+
+    enum class AllocationStage : std::uint8_t
+    {
+        Other,
+        Input,
+        GameEvents,
+        ItemsControl,
+        Collision,
+        ItemsUpdate,
+        Particles,
+        Text,
+        RenderQueue,
+        RenderSubmit,
+        Display,
+        Network,
+        Music,
+        Count
+    };
+
+    struct AllocationCounters
+    {
+        /// @brief number of allocations
+        std::uint64_t count = 0;
+        /// @brief number of allocated bytes
+        std::uint64_t bytes = 0;
+    };
+
+    /// @brief allocation counters of every stage since program start
+    using AllocationReport = std::array<AllocationCounters,static_cast<std::size_t>(AllocationStage::Count)>;
+
+    /// @brief attributes allocations of the calling thread to a stage until scope end
+    class AllocationScope
+    {
+        public:
+#ifdef SI_ALLOCATION_TRACKING
+            /// @brief default constructor
+            /// @param stage stage of the following allocations
+            explicit AllocationScope(AllocationStage stage);
+            ~AllocationScope();
+        private:
+            /// @brief stage restored at scope end
+            AllocationStage previous;
+#else
+            explicit AllocationScope(AllocationStage){}
+#endif
+    };
+
+    /// @brief get allocation counters, all zero if tracking is not compiled in
+    /// @return actual counters
+    AllocationReport getAllocations();
+    /// @brief get allocations made after baseline
+    /// @param baseline counters taken earlier with getAllocations
+    /// @return counters difference
+    AllocationReport getAllocationsSince(const AllocationReport& baseline);
+    /// @brief count allocations in report
+    /// @param report allocation counters
+    /// @return sum of all stages
+    AllocationCounters getTotal(const AllocationReport& report);
+    /// @brief print stages with allocations
+    /// @param report allocation counters
+    /// @param stream output stream
+    void printAllocations(const AllocationReport& report, std::ostream& stream);
+}
+
+#endif //ALLOC_H
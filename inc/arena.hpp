@@ -0,0 +1,95 @@
+/**
+ * @file arena.hpp
+ *
+ * @brief per-frame bump allocator for transient data
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace si
+{
+    ////////////////////////ARENA SETTINGS//////////////////////////////////////////
+    //initial arena size, grows on reset if frame needed more
+    constexpr std::size_t default_arena_size = 64*1024;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class FrameArena
+    {
+        public:
+            /// @brief default constructor
+            /// @param capacity initial size of arena buffer
+            explicit FrameArena(std::size_t capacity = default_arena_size);
+            /// @brief allocate memory valid until next reset, never freed separately
+            /// @param size number of bytes
+            /// @param alignment required alignment
+            /// @return pointer to allocated memory
+            void* allocate(std::size_t size, std::size_t alignment);
+            /// @brief release all frame allocations, buffer grows here if frame did not fit in it
+            void reset();
+            /// @brief get number of bytes used in actual frame
+            /// @return used bytes
+            std::size_t getUsed() const {return used;}
+            /// @brief get number of allocations that did not fit in buffer since start
+            /// @return number of heap fallbacks
+            std::size_t getOverflows() const {return overflows;}
+
+        private:
+            /// @brief arena memory
+            std::unique_ptr<unsigned char[]> buffer;
+            /// @brief buffer size
+            std::size_t capacity;
+            /// @brief first free byte in buffer
+            std::size_t offset = 0;
+            /// @brief total size requested in actual frame, including overflows
+            std::size_t used = 0;
+            /// @brief total number of heap fallbacks
+            std::size_t overflows = 0;
+            /// @brief heap blocks for allocations that did not fit, freed on reset
+            std::vector<std::unique_ptr<unsigned char[]>> overflow_blocks;
+    };
+
+    template<class T>
+    class ArenaAllocator
+    {
+        public:
+            using value_type = T;
+            /// @brief default constructor
+            /// @param arena arena used for all allocations
+            ArenaAllocator(FrameArena& arena) : arena(&arena){}
+            /// @brief rebind constructor
+            template<class U>
+            ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.getArena()){}
+            /// @brief allocate memory for n objects in arena
+            T* allocate(std::size_t n){return static_cast<T*>(arena->allocate(n*sizeof(T),alignof(T)));}
+            /// @brief memory is released on arena reset only
+            void deallocate(T*, std::size_t){}
+            /// @brief get used arena
+            FrameArena* getArena() const {return arena;}
+
+        private:
+            /// @brief used arena
+            FrameArena* arena;
+    };
+
+    template<class T, class U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b){return a.getArena() == b.getArena();}
+    template<class T, class U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b){return !(a == b);}
+
+    /// @brief string for transient text, valid until arena reset
+    using ScratchString = std::basic_string<char,std::char_traits<char>,ArenaAllocator<char>>;
+    /// @brief vector for transient lists, valid until arena reset
+    template<class T>
+    using ScratchVector = std::vector<T,ArenaAllocator<T>>;
+}
+
+#endif //ARENA_H
@@ -0,0 +1,70 @@
+/**
+ * @file audio.hpp
+ *
+ * @brief game sounds with optional deferred audio device initialization
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <SFML/Audio.hpp>
+
+namespace si
+{
+    enum class SoundId : std::size_t
+    {
+        Shoot,
+        InvaderKilled,
+        PlayerKilled,
+        Ship,
+        Count
+    };
+
+    enum class AudioMode
+    {
+        /// @brief sounds are ignored, audio device is never opened
+        Disabled,
+        /// @brief audio device and buffers are created on first played sound
+        Lazy,
+        /// @brief audio device and buffers are created in setup
+        Eager
+    };
+
+    class GameAudio
+    {
+        public:
+            /// @brief setup audio mode, loads all sounds in eager mode
+            /// @param mode expected audio mode
+            void setup(AudioMode mode);
+            /// @brief play sound, loads all sounds first in lazy mode
+            /// @param id sound identifier
+            void play(SoundId id);
+            /// @brief stop sound, does nothing if sounds are not loaded
+            /// @param id sound identifier
+            void stop(SoundId id);
+            /// @brief check if audio device and buffers are created
+            /// @return true if sounds are loaded
+            bool isLoaded() const {return loaded;}
+
+        private:
+            static constexpr std::size_t num_of_sounds = static_cast<std::size_t>(SoundId::Count);
+            /// @brief actual audio mode
+            AudioMode mode = AudioMode::Disabled;
+            /// @brief flag that buffers and sounds are created
+            bool loaded = false;
+            /// @brief sound buffers, created on load only since they open audio device
+            std::array<std::unique_ptr<sf::SoundBuffer>,num_of_sounds> buffers;
+            /// @brief sound interfaces
+            std::array<std::unique_ptr<sf::Sound>,num_of_sounds> sounds;
+            /// @brief open audio device and load all sound buffers
+            void load();
+    };
+}
+
+#endif //AUDIO_H
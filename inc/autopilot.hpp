@@ -0,0 +1,106 @@
+/**
+ * @file autopilot.hpp
+ *
+ * @brief scripted player and headless soak runner
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <cstdint>
+#include <ostream>
+#include "game.hpp"
+
+namespace si
+{
+    ////////////////////////AUTOPILOT SETTINGS//////////////////////////////////////
+    //enemy shells closer than this number of ticks are dodged, scaled down by aggression
+    constexpr float dodge_lookahead_ticks = 90.f;
+    //extra horizontal space around player ship for dodge decisions, in pixels
+    constexpr float dodge_margin = 10.f;
+    //period of soak statistics output in simulated seconds
+    constexpr int soak_report_period_s = 60;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class Autopilot
+    {
+        public:
+            /// @brief default constructor
+            /// @param aggression value from 0 (careful) to 1 (never dodges, fires constantly)
+            explicit Autopilot(float aggression);
+            /// @brief read game state and send key events to executeEvent, called once per tick
+            /// @param game reference to game instance of any variant
+            template<class GameType>
+            void drive(GameType& game);
+
+        private:
+            /// @brief value from 0 to 1, see constructor
+            float aggression;
+            /// @brief left key is held
+            bool left_held = false;
+            /// @brief right key is held
+            bool right_held = false;
+            /// @brief player lives seen on previous tick, used to detect player reset
+            int player_lives = -1;
+            /// @brief press or release key if its state differs
+            /// @param game reference to game instance
+            /// @param key keyboard key
+            /// @param held actual key state
+            /// @param pressed expected key state
+            template<class GameType>
+            void setKey(GameType& game, sf::Keyboard::Key key, bool& held, bool pressed);
+            /// @brief press and release key
+            /// @param game reference to game instance
+            /// @param key keyboard key
+            template<class GameType>
+            void tapKey(GameType& game, sf::Keyboard::Key key);
+            /// @brief find horizontal direction away from nearest falling shell
+            /// @param game reference to game instance
+            /// @return -1 to move left, 1 to move right, 0 if there is no threat
+            template<class GameType>
+            int findDodge(const GameType& game) const;
+    };
+
+    enum class GameVariant
+    {
+        Classic,
+        Stress,
+        Benchmark
+    };
+
+    struct SoakOptions
+    {
+        /// @brief number of simulated ticks, 0 to run forever
+        std::uint64_t ticks = 0;
+        /// @brief game variant, simulation tickrate is defined by variant config
+        GameVariant variant = GameVariant::Classic;
+        /// @brief autopilot aggression
+        float aggression = 0.5f;
+        /// @brief random generator seed, same seed gives same workload
+        std::uint32_t seed = 1;
+        /// @brief pace ticks with wall clock, otherwise run as fast as possible
+        bool realtime = false;
+        /// @brief number of warm-up ticks after which any allocation fails the run, 0 to disable check
+        std::uint64_t allocation_warmup = 0;
+        /// @brief sample hardware counters of game stages and print them with results
+        bool perf_counters = false;
+        /// @brief stream music tracks to null output, one tick of samples per tick
+        bool music = false;
+        /// @brief override variant threshold of parallel collision detection
+        bool parallel_collision = false;
+        /// @brief number of live shells from which collision detection runs on thread pool,
+        /// used with parallel_collision only, 0 for every tick
+        std::size_t parallel_threshold = 0;
+    };
+
+    /// @brief run headless game driven by autopilot and print workload statistics
+    /// @param options soak options
+    /// @param stream output stream for statistics
+    /// @return false if allocation check is enabled and allocation happened after warm-up
+    bool runSoak(const SoakOptions& options, std::ostream& stream);
+}
+
+#endif //AUTOPILOT_H
@@ -11,25 +11,58 @@
 #define CANVAS_H
 
 #include <array>
+#include <memory>
+#include "audio.hpp"
+#include "capture.hpp"
 #include "game.hpp"
+#include "governor.hpp"
+#include "mask.hpp"
+#include "music.hpp"
+#include "network.hpp"
+#include "pacer.hpp"
+#include "render.hpp"
+#include "scene.hpp"
+#include "startup.hpp"
 
 //////////////////////////////CANVAS SETTINGS///////////////////////////////////
-constexpr          int num_of_frames    = 5;
 constexpr          int font_size        = 32;
 constexpr unsigned int canvas_width     = 500;
 constexpr unsigned int canvas_height    = 500;
+constexpr          int num_of_welcome_lines   = 5;
+constexpr          int num_of_game_over_lines = 3;
 ////////////////////////////////////////////////////////////////////////////////
 
-struct GameMenuSprites 
+struct CanvasOptions
+{
+    /// @brief frame pacing without spin-wait
+    bool power_saving = false;
+    /// @brief rasterize all glyphs of menu texts during loading
+    bool glyph_prewarm = true;
+    /// @brief open audio device and load sounds on first played sound
+    bool lazy_audio = false;
+    /// @brief stream background music, tracks follow game screens
+    bool music = false;
+    /// @brief sample hardware counters of game stages, ignored if counters are not available
+    bool perf_counters = false;
+    /// @brief shed optional work when frames run over budget
+    bool governor = true;
+    /// @brief print governor decision of every window
+    bool governor_log = false;
+    /// @brief write rendered frames to image sequence if directory is not empty
+    si::CaptureOptions capture;
+    /// @brief application start, beginning of startup timeline
+    StartupTimeline::clock::time_point start_time = StartupTimeline::clock::now();
+};
+
+/// @brief score, lives and frames are recorded by scene like in render benchmark
+struct GameMenuSprites : si::HudSprites
 {
-    /// @brief sprite with game score
-    sf::Text score;
     /// @brief text with initial text
     sf::Text start_text;
-    /// @brief sprite with player live
-    sf::Sprite live;
-    /// @brief array with canvas frames
-    std::array<Object,num_of_frames> frames; 
+    /// @brief lines of welcome screen
+    std::array<sf::Text,num_of_welcome_lines> welcome;
+    /// @brief lines of game over screen
+    std::array<sf::Text,num_of_game_over_lines> game_over;
 };
 
 struct GameResources
@@ -50,17 +83,18 @@ struct GameResources
     sf::Texture obstacle;
     /// @brief texture with canvas frame
     sf::Texture frame;
+    /// @brief collision mask of player ship
+    si::CollisionMask player_mask;
+    /// @brief collision mask of invader
+    si::CollisionMask enemy_type_1_mask;
+    /// @brief collision mask of alternative invader
+    si::CollisionMask enemy_type_2_mask;
+    /// @brief collision mask of alternative invader
+    si::CollisionMask enemy_type_3_mask;
+    /// @brief collision mask of enemy ship
+    si::CollisionMask enemy_ship_mask;
     /// @brief font for text on canvas
     sf::Font game_font;
-    /// @brief struct with game sounds resources
-    // shot sound buffer
-    sf::SoundBuffer shoot_sound_buffer;
-    // invader killed sound buffer
-    sf::SoundBuffer invader_killed_sound_buffer;
-    // player killed sound buffer
-    sf::SoundBuffer player_killed_sound_buffer;
-    // ship sound buffer
-    sf::SoundBuffer ship_sound_buffer;
 };
 
 class Canvas
@@ -68,11 +102,19 @@ class Canvas
     public:
         /// @brief default constructor
         /// @param framerate canvas initial framerate
-        Canvas( const unsigned int framerate);
+        /// @param options canvas options
+        /// @param client remote game client, game is rendered from server snapshots if not nullptr
+        Canvas( const unsigned int framerate, const CanvasOptions& options = CanvasOptions(), si::Client* client = nullptr);
         /// @brief game main function
         void runEventLoop();
 
     private:     
+        /// @brief canvas options
+        CanvasOptions options;
+        /// @brief startup phase timestamps, printed after first frame
+        StartupTimeline startup;
+        /// @brief flag that first frame is presented
+        bool first_frame_presented = false;
         /// @brief pointer to SFML window
         sf::RenderWindow window;
         /// @brief struct with resources for game objects 
@@ -81,21 +123,64 @@ class Canvas
         GameMenuSprites menu_sprites;
         /// @brief main game class
         si::Game game; 
+        /// @brief frame pacer, replaces SFML framerate limit
+        FramePacer pacer;
+        /// @brief sheds optional work on slow frames
+        FrameGovernor governor;
+        /// @brief remote game client, nullptr for local game
+        si::Client* client;
+        /// @brief score shown in text items, text is rebuilt only on score events
+        int shown_score = -1;
+        /// @brief latest score from game events, shown when HUD refresh period allows
+        int pending_score = 0;
+        /// @brief frames since score text was rebuilt
+        unsigned int frames_since_score = 0;
+        /// @brief number of lives shown in HUD, changed only on lives events
+        int shown_lives = si::default_num_of_lives;
+        /// @brief game sounds, played on game events
+        si::GameAudio audio;
+        /// @brief background music, created only with music option
+        std::unique_ptr<si::MusicStream> music;
+        /// @brief audio device output of background music, destroyed before music
+        std::unique_ptr<si::MusicOutput> music_output;
+        /// @brief telemetry of drained game events
+        si::GameEventCounters event_counters;
+        /// @brief hardware counters, created only with perf_counters option
+        std::unique_ptr<si::PerfCounters> perf;
+        /// @brief frame capture, created only if capture directory is set
+        std::unique_ptr<si::FrameCapture> capture;
+        /// @brief draw commands of actual frame
+        si::RenderQueue render_queue;
+        /// @brief backend that draws command list on the window
+        si::SfmlBackend render_backend;
+        /// @brief screens that were already shown, indexed by game status
+        std::array<bool,4> seen_screens{};
+        /// @brief worst time of frame where text appeared first time or was rebuilt
+        FramePacer::clock::duration worst_text_frame = FramePacer::clock::duration::zero();
         /// @brief resources loading from external files
         void loadResources();
         /// @brief setup game sounds
         void setupSounds();
+        /// @brief open music tracks and start playback
+        void startMusic();
         /// @brief setup items textures
         void setupTextures();
         /// @brief setup all non moving canvas items 
         void setupMenu();
-        /// @brief render items on canvas according to their actual state
+        /// @brief record items of game screen according to their actual state
         void updateCanvas();
-        /// @brief draw actual number of player lives
-        void drawPlayerLives();
-        /// @brief draw window with welcome and press and key screen
+        /// @brief rasterize all characters of menu texts in the font glyph cache
+        void prewarmGlyphs();
+        /// @brief drain game event bus and pass events to audio, HUD and telemetry
+        /// @return true if score text was rebuilt
+        bool processGameEvents();
+        /// @brief rebuild score text items if score was changed
+        /// @param score new score
+        /// @return true if text was rebuilt
+        bool updateScore(int score);
+        /// @brief record window with welcome and press and key screen
         void drawWelcomeWindow();
-        /// @brief draw window with game over and final score
+        /// @brief record window with game over and final score
         void drawGameOverScreen();
 };      
 
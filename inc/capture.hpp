@@ -0,0 +1,173 @@
+/**
+ * @file capture.hpp
+ *
+ * @brief asynchronous capture of rendered frames to image sequence
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/System.hpp>
+
+namespace si
+{
+    ////////////////////////CAPTURE SETTINGS////////////////////////////////////////
+    //number of preallocated frame buffers, frames are dropped when all of them are encoded
+    constexpr std::size_t capture_slots = 8;
+    //number of pixel pack buffers, frame is mapped when its buffer is reused,
+    //so GL has two more frames to finish the copy
+    constexpr std::size_t capture_readback_buffers = 3;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum class CaptureFormat
+    {
+        /// @brief fast lossless format, encoded by the capture itself
+        Qoi,
+        /// @brief encoded by sf::Image, several times slower
+        Png
+    };
+
+    struct CaptureOptions
+    {
+        /// @brief output directory, created if it does not exist
+        std::string directory;
+        /// @brief image format
+        CaptureFormat format = CaptureFormat::Qoi;
+        /// @brief number of frame buffers
+        std::size_t slots = capture_slots;
+        /// @brief number of encoding threads, 0 for half of hardware threads
+        std::size_t workers = 0;
+        /// @brief read back through pixel buffer objects if GL supports them, synchronous read otherwise
+        bool async_readback = true;
+    };
+
+    /// @brief main thread reads back frame into a free buffer, workers encode and write it,
+    /// GL context of the target shall be active on every call except finish
+    class FrameCapture
+    {
+        public:
+            /// @brief default constructor, all frame buffers are allocated here
+            /// @param options capture options
+            /// @param size size of captured frames in pixels
+            FrameCapture(const CaptureOptions& options, sf::Vector2u size);
+            ~FrameCapture();
+            FrameCapture(const FrameCapture&) = delete;
+            FrameCapture& operator=(const FrameCapture&) = delete;
+            /// @brief read back buffer of active GL context before display, never waits for workers,
+            /// with pixel buffer objects the frame is copied to a free buffer some frames later
+            /// @param size actual target size, frame is dropped if it differs from capture size
+            void captureFrame(sf::Vector2u size);
+            /// @brief write all queued frames and stop workers, pending pixel buffers are read with
+            /// own context, target may be closed already
+            void finish();
+            /// @brief print number of captured, written and dropped frames and main thread time
+            /// @param stream output stream
+            void printStatistics(std::ostream& stream) const;
+
+        private:
+            using clock = std::chrono::steady_clock;
+
+            struct Readback
+            {
+                /// @brief GL pixel pack buffer
+                unsigned int buffer = 0;
+                /// @brief frame number of pending copy, 0 if buffer is free
+                std::uint64_t frame = 0;
+            };
+
+            struct Slot
+            {
+                /// @brief RGBA pixels, bottom row first as returned by GL
+                std::vector<std::uint8_t> pixels;
+                /// @brief frame number
+                std::uint64_t frame = 0;
+                /// @brief slot is queued or encoded by worker
+                std::atomic<bool> busy{false};
+            };
+            /// @brief capture options
+            CaptureOptions options;
+            /// @brief frame size
+            sf::Vector2u size;
+            /// @brief frame buffers
+            std::unique_ptr<Slot[]> slots;
+            /// @brief next slot to fill, frames are written in order of capture
+            std::size_t next_slot = 0;
+            /// @brief pixel pack buffers, used if async is set, deleted by finish
+            std::array<Readback,capture_readback_buffers> readbacks;
+            /// @brief next pixel pack buffer to fill
+            std::size_t next_readback = 0;
+            /// @brief support of pixel buffer objects is checked on first frame, when context is active
+            bool readback_checked = false;
+            /// @brief frames are read back through pixel pack buffers
+            bool async = false;
+            /// @brief main thread time spent in captureFrame
+            clock::duration capture_time = clock::duration::zero();
+            /// @brief number of frames passed to captureFrame
+            std::uint64_t frames = 0;
+            /// @brief number of dropped frames
+            std::uint64_t dropped = 0;
+            /// @brief number of written frames
+            std::atomic<std::uint64_t> written{0};
+            /// @brief number of frames that were not written because of file errors
+            std::atomic<std::uint64_t> failed{0};
+            /// @brief queue of filled slots, capacity is number of slots
+            std::vector<std::size_t> queue;
+            /// @brief first queued slot
+            std::size_t queue_head = 0;
+            /// @brief number of queued slots
+            std::size_t queue_size = 0;
+            /// @brief workers stop when queue is empty
+            bool stopping = false;
+            /// @brief queue protection
+            std::mutex mutex;
+            /// @brief workers wake-up
+            std::condition_variable wake;
+            /// @brief encoding threads
+            std::vector<std::thread> workers;
+            /// @brief create pixel pack buffers if options and GL allow it
+            void setupReadback();
+            /// @brief get next slot for filled frame
+            /// @param wait wait for workers instead of dropping the frame
+            /// @return free slot or nullptr if frame is dropped
+            Slot* acquireSlot(bool wait);
+            /// @brief pass next slot to workers
+            /// @param frame frame number
+            void queueSlot(std::uint64_t frame);
+            /// @brief start copy of back buffer into next pixel pack buffer, previous copy of it is collected first
+            void readAsync();
+            /// @brief map bound pixel pack buffer and copy its frame into a slot
+            /// @param readback pending pixel pack buffer
+            /// @param wait wait for free slot
+            void collect(Readback& readback, bool wait);
+            /// @brief encoding thread function
+            void work();
+            /// @brief encode slot and write it to file
+            /// @param slot filled slot
+            /// @param buffer encoder output, reused by worker
+            /// @return true if file is written
+            bool write(const Slot& slot, std::vector<std::uint8_t>& buffer) const;
+    };
+
+    /// @brief encode RGBA pixels to QOI image
+    /// @param pixels RGBA pixels, rows are stored bottom row first
+    /// @param size image size
+    /// @param output destination, cleared first
+    void encodeQoi(const std::uint8_t* pixels, sf::Vector2u size, std::vector<std::uint8_t>& output);
+}
+
+#endif //CAPTURE_H
@@ -0,0 +1,130 @@
+/**
+ * @file events.hpp
+ *
+ * @brief game events passed from simulation to presentation through wait-free ring
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace si
+{
+    ////////////////////////EVENTS SETTINGS/////////////////////////////////////////
+    //number of events kept until consumer drains them, shall be power of two
+    constexpr std::size_t game_event_capacity = 1024;
+    //indices of producer and consumer are placed in different cache lines
+    constexpr std::size_t cache_line_size = 64;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum class GameEventType : std::uint8_t
+    {
+        /// @brief value is ShellType
+        Shot,
+        /// @brief value is invader index in the grid
+        InvaderKilled,
+        /// @brief value is number of lives left
+        LifeLost,
+        ShipSpawned,
+        ShipLeft,
+        ShipKilled,
+        /// @brief value is actual score
+        ScoreChanged,
+        /// @brief value is actual number of lives
+        LivesChanged,
+        GameOver,
+        Count
+    };
+
+    struct GameEvent
+    {
+        /// @brief event type
+        GameEventType type;
+        /// @brief event payload, meaning depends on type
+        std::int32_t value;
+    };
+
+    /// @brief single producer single consumer ring, push and drain never wait
+    template<class T, std::size_t Capacity>
+    class SpscRing
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "ring capacity shall be power of two");
+
+        public:
+            /// @brief add item, called by producer thread only
+            /// @param item new item
+            /// @return false if ring is full and item is dropped
+            bool push(const T& item);
+            /// @brief pass all available items to callback, called by consumer thread only
+            /// @param callback function with const T& argument
+            /// @return number of passed items
+            template<class Callback>
+            std::size_t drain(Callback callback);
+
+        private:
+            static constexpr std::size_t mask = Capacity - 1;
+            /// @brief next slot to write, changed by producer
+            alignas(cache_line_size) std::atomic<std::size_t> head{0};
+            /// @brief producer copy of tail, reloaded only when ring looks full
+            std::size_t cached_tail = 0;
+            /// @brief next slot to read, changed by consumer
+            alignas(cache_line_size) std::atomic<std::size_t> tail{0};
+            /// @brief ring storage
+            alignas(cache_line_size) std::array<T,Capacity> items{};
+    };
+
+    template<class T, std::size_t Capacity>
+    bool SpscRing<T,Capacity>::push(const T& item)
+    {
+        const auto position = head.load(std::memory_order_relaxed);
+        if(position - cached_tail == Capacity)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if(position - cached_tail == Capacity){return false;}
+        }
+        items[position & mask] = item;
+        head.store(position + 1,std::memory_order_release);
+        return true;
+    }
+
+    template<class T, std::size_t Capacity>
+    template<class Callback>
+    std::size_t SpscRing<T,Capacity>::drain(Callback callback)
+    {
+        const auto first = tail.load(std::memory_order_relaxed);
+        const auto last  = head.load(std::memory_order_acquire);
+        for(auto position = first; position != last; ++position){callback(items[position & mask]);}
+        //slots are released after all of them are read
+        tail.store(last,std::memory_order_release);
+        return last - first;
+    }
+
+    /// @brief events from simulation to audio, HUD and telemetry consumers
+    using GameEventBus = SpscRing<GameEvent,game_event_capacity>;
+
+    /// @brief telemetry consumer, counts events by type
+    class GameEventCounters
+    {
+        public:
+            /// @brief count one event
+            /// @param event drained event
+            void count(const GameEvent& event){++counters[static_cast<std::size_t>(event.type)];}
+            /// @brief print number of events of every type
+            /// @param stream output stream
+            void print(std::ostream& stream) const;
+
+        private:
+            /// @brief number of events by type
+            std::array<std::uint64_t,static_cast<std::size_t>(GameEventType::Count)> counters{};
+    };
+}
+
+#endif //EVENTS_H
@@ -0,0 +1,116 @@
+/**
+ * @file formation.hpp
+ *
+ * @brief index of live invaders in the formation grid
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef FORMATION_H
+#define FORMATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "items.hpp"
+
+namespace si
+{
+    /// @brief formation grid size is taken from game variant config
+    template<class Config>
+    class Formation
+    {
+        public:
+            static constexpr int invaders_in_row    = Config::invaders_in_row;
+            static constexpr int rows_with_invaders = Config::rows_with_invaders;
+            static constexpr int invaders_in_grid   = invaders_in_row*rows_with_invaders;
+            static_assert(invaders_in_row <= 32, "columns are selected with 32-bit mask");
+            /// @brief invaders of the grid, row by row from the top
+            using Invaders = std::array<Invader,invaders_in_grid>;
+
+            /// @brief default constructor, all invaders are alive
+            Formation(){reset();}
+            /// @brief mark all invaders as alive
+            void reset();
+            /// @brief remove killed invader from the index, O(1) for shooters,
+            /// O(rows + columns) for bounds
+            /// @param index invader index in the grid (row by row from the top)
+            /// @param enemies invaders of the grid, killed one is already invisible
+            void removeInvader(int index, const Invaders& enemies);
+            /// @brief compute bounds of rows, columns and whole formation from visible invaders
+            /// @param enemies invaders of the grid
+            void setupBounds(const Invaders& enemies);
+            /// @brief follow formation movement, all live invaders move together
+            /// @param enemies invaders of the grid
+            void updateOffset(const Invaders& enemies);
+            /// @brief call function for every grid cell which bounds overlap with area,
+            /// cells of killed invaders are not skipped, only one rejection test if area is outside formation
+            /// @param area tested area on canvas
+            /// @param callback function with invader index argument
+            template<class Callback>
+            void forEachCandidate(const sf::FloatRect& area, Callback callback) const;
+            /// @brief get number of columns with at least one live invader
+            /// @return number of live columns
+            std::size_t getLiveColumns() const {return num_of_live_columns;}
+            /// @brief get bottom-most live invader of the live column, O(1)
+            /// @param live_column live column number in range [0, getLiveColumns())
+            /// @return invader index in the grid
+            int getShooter(std::size_t live_column) const {return bottom[live_columns[live_column]];}
+
+        private:
+            /// @brief next live invader above in the same column, -1 if none
+            std::array<int,invaders_in_grid> above;
+            /// @brief next live invader below in the same column, -1 if none
+            std::array<int,invaders_in_grid> below;
+            /// @brief bottom-most live invader of every column, -1 if column is empty
+            std::array<int,invaders_in_row> bottom;
+            /// @brief dense array of columns with live invaders
+            std::array<int,invaders_in_row> live_columns;
+            /// @brief position of every column in live_columns
+            std::array<std::size_t,invaders_in_row> column_slot;
+            /// @brief actual size of live_columns
+            std::size_t num_of_live_columns;
+            /// @brief bounds of every row in formation coordinates (invaders in default positions)
+            std::array<sf::FloatRect,rows_with_invaders> row_bounds;
+            /// @brief bounds of every column in formation coordinates
+            std::array<sf::FloatRect,invaders_in_row> column_bounds;
+            /// @brief bounds of whole formation in formation coordinates
+            sf::FloatRect bounds;
+            /// @brief actual formation offset from default positions
+            sf::Vector2f offset;
+            /// @brief recompute bounds of one row
+            /// @param row row number
+            /// @param enemies invaders of the grid
+            void updateRowBounds(int row, const Invaders& enemies);
+            /// @brief recompute bounds of one column
+            /// @param column column number
+            /// @param enemies invaders of the grid
+            void updateColumnBounds(int column, const Invaders& enemies);
+            /// @brief recompute whole formation bounds from row bounds
+            void updateFormationBounds();
+    };
+
+    template<class Config>
+    template<class Callback>
+    void Formation<Config>::forEachCandidate(const sf::FloatRect& area, Callback callback) const
+    {
+        const sf::FloatRect local(area.left - offset.x,area.top - offset.y,area.width,area.height);
+        if(!local.intersects(bounds)){return;}
+        std::uint32_t columns = 0;
+        for(auto column = 0; column < invaders_in_row; ++column)
+        {
+            if(local.intersects(column_bounds[column])){columns |= (1u << column);}
+        }
+        for(auto row = 0; row < rows_with_invaders; ++row)
+        {
+            if(!local.intersects(row_bounds[row])){continue;}
+            for(auto column = 0; column < invaders_in_row; ++column)
+            {
+                if(columns & (1u << column)){callback(row*invaders_in_row + column);}
+            }
+        }
+    }
+}
+
+#endif //FORMATION_H
@@ -10,12 +10,21 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <memory>
 #include <random>
-#include <SFML/Audio.hpp>
 #include "items.hpp"
+#include "events.hpp"
+#include "formation.hpp"
+#include "live.hpp"
+#include "variants.hpp"
+#include "arena.hpp"
+#include "pool.hpp"
+#include "timers.hpp"
+#include "particles.hpp"
+#include "perf.hpp"
 
 namespace si
 {
@@ -28,27 +37,26 @@ namespace si
     constexpr float default_y_size     = 1000.f;
     //border size around game field
     constexpr float default_border_size = 50.f;
-    //max 10 items per one row
-    constexpr float grid_row_step = default_x_size/15.f;
-    //speed setup (greed per second)
-    constexpr float default_invader_speed = 30.f;
-    constexpr float default_ship_speed    = 100.f;
-    constexpr float default_shell_speed   = 200.f;
-    constexpr float default_player_speed  = 400.f;
     //limits for player movement
     constexpr float bottom_left_x   = static_cast<float>(frame_width);
     constexpr float bottom_right_x  = default_x_size - static_cast<float>(frame_width);
     constexpr float bottom_left_y   = default_y_size - default_border_size;
     constexpr float bottom_right_y  = default_y_size - default_border_size;
-    //game logic config
-    constexpr int   invaders_in_row     = 10;
-    constexpr int   rows_with_invaders  = 6; 
-    constexpr int invader_shot_period_s = 1;
-    constexpr int ship_spawn_period_s   = 15;
+    //obstacles layout: 4 structs with 10*5 obstacles
+    constexpr int obstacles_in_row      = 10;
+    constexpr int struct_with_obstacles = 4;
+    constexpr int rows_with_obstacles   = 5;
+    constexpr int obstacles_in_grid     = obstacles_in_row*struct_with_obstacles*rows_with_obstacles;
+    //game logic config, grid size, speeds and periods are in variants.hpp
     constexpr int invader_reward        = 10;
     constexpr int invader_ship_reward   = 250;
     constexpr int default_num_of_lives  = 3;
     constexpr int max_num_of_lives      = 5;
+    //number of debris particles for explosions
+    constexpr std::size_t invader_debris = 48;
+    constexpr std::size_t player_debris  = 256;
+    //number of shells in one chunk of parallel collision detection
+    constexpr std::size_t collision_grain = 128;
     ////////////////////////////////////////////////////////////////////////////////
     
     enum class GameStatus
@@ -59,44 +67,30 @@ namespace si
         Closed
     };
 
+    /// @brief delayed game events, scheduled in game timer wheel
+    enum class GameTimer : std::uint32_t
+    {
+        /// @brief periodic enemy shot
+        InvaderShot,
+        /// @brief invader ship appears, scheduled when previous ship leaves the canvas
+        ShipSpawn,
+        /// @brief player can shoot again
+        PlayerReload,
+        /// @brief new wave of invaders after the last one is killed
+        WaveRespawn,
+        Count
+    };
+
     struct GameControl
     {
-        /// @brief counter for invader shot event, event will be generated when this counter be equal to invader_shot_period
-        std::uint32_t invader_shot_counter = 0;
-        /// @brief counter for invader ship spawn event, event will be generated when this counter be equal to ship_spawn_period
-        std::uint32_t ship_spawn_counter = 0;
-        /// @brief counter for player reload event, event will be generated when this counter be equal to player_reload_period
-        std::uint32_t player_reload_counter = 0;
         /// @brief actual number of invader on th canvas
         std::uint32_t invaders_left = 0;
-        /// @brief flag that invader ship is on the canvas now
-        bool invader_ship_spawned = false;
-        /// @brief label for player reload logic, when shot is not performed
-        bool player_reload = false;
         /// @brief left key is pressed
         bool left_pressed = false;
         /// @brief right key is pressed
         bool right_pressed = false;
     };
 
-    struct GameConfig
-    {
-        /// @brief shot period, compared with event_counter from GameControl
-        std::uint32_t invader_shot_period = 0;
-        /// @brief ship spawn period, compared with event_counter from GameControl
-        std::uint32_t ship_spawn_period = 0;
-        /// @brief player reload period in framerate ticks
-        std::uint32_t player_reload_period = 0;
-        /// @brief actual player speed, adjusted with actual framerate
-        float player_speed;
-        /// @brief actual invader ship speed, adjusted with actual framerate
-        float enemy_ship_speed;
-        /// @brief actual invader speed, adjusted with actual framerate
-        float invader_speed;
-        /// @brief actual shell speed, adjusted with actual framerate
-        float shell_speed;
-    };
-
     struct GameElements
     {
         /// @brief actual game score
@@ -105,54 +99,148 @@ namespace si
         int player_lives = default_num_of_lives;
     };
 
-    struct GameSounds
+    enum class ContactKind : std::uint8_t
     {
-        // shot sound interface
-        sf::Sound shoot_sound;
-        // invader killed sound interface
-        sf::Sound invader_killed_sound;
-        // player killed sound interface
-        sf::Sound player_killed_sound;
-        // ship sound interface
-        sf::Sound ship_sound;
+        Player,
+        Invader,
+        InvaderShip,
+        Obstacle
     };
 
-    class Game
+    struct Contact
+    {
+        /// @brief normalized time of contact during the tick
+        float time;
+        /// @brief shell index in bullets vector
+        std::uint32_t shell;
+        /// @brief target index in its vector, 0 for player ship and invader ship
+        std::uint32_t target;
+        /// @brief target type
+        ContactKind kind;
+    };
+
+    /// @brief list of contacts found during one tick, stored in frame arena
+    using ContactList = ScratchVector<Contact>;
+
+    /// @brief game logic specialized at compile time with variant config, see variants.hpp
+    template<class Config>
+    class BasicGame
     {
         public:
-            Game(unsigned int framerate);
-            /// @brief vector with invaders
-            std::vector<Invader> enemies;
+            using config_type = Config;
+            /// @brief simulation ticks per second
+            static constexpr unsigned int tickrate = Config::tickrate;
+            BasicGame();
+            /// @brief invaders, row by row from the top
+            std::array<Invader,Formation<Config>::invaders_in_grid> enemies;
             /// @brief vector with shell instances
             std::vector<Shell> bullets;
-            /// @brief vector with player obstacles from invaders
-            std::vector<Obstacle> obstacles;
+            /// @brief player obstacles from invaders
+            std::array<Obstacle,obstacles_in_grid> obstacles;
             /// @brief pointer to player ship
             std::unique_ptr<PlayerShip> player;        
             /// @brief pointer to invader ship
             std::unique_ptr<InvaderShip> invader_ship;
             /// @brief actual game status
             GameStatus status;
-            /// @brief used game sounds
-            GameSounds sounds;
+            /// @brief game events for presentation, drained by the game owner
+            GameEventBus events;
             /// @brief struct with game elements
             GameElements elements;
+            /// @brief scratch memory for transient per-frame data, reset by the frame owner
+            FrameArena arena;
+            /// @brief explosion debris
+            ParticleSystem particles;
             /// @brief main game loop
             void gameLoop();
-            /// @brief calculate items speed based on actual framerate
-            /// @param framerate expected framerate
-            void calculateItemsSpeed(const unsigned int framerate);
             /// @brief SFML event executor for windowEventHandler
             /// @param event reference to actual captured event
             void executeEvent(const sf::Event& event);
+            /// @brief setup number of shells from which collision detection runs in parallel
+            /// @param threshold number of shells, 0 to run every detection on thread pool,
+            /// threads are started on first parallel detection only
+            /// @param threads number of background threads of the pool
+            void setParallelThreshold(std::size_t threshold, std::size_t threads = ThreadPool::defaultThreads())
+            {
+                parallel_threshold = threshold;
+                collision_threads  = threads;
+                pool.reset();
+            }
+            /// @brief seed random generator, used for repeatable runs
+            /// @param seed random generator seed
+            void setSeed(std::uint32_t seed){randomizer.seed(seed);}
+            /// @brief setup hardware counters for collision and items update stages
+            /// @param counters pointer to counters owned by caller, nullptr to disable
+            void setPerfCounters(PerfCounters* counters){perf = counters;}
+            /// @brief enable explosion particles, disabled when game is not rendered
+            /// @param enabled false to skip particles emission and update
+            void setEffects(bool enabled){effects = enabled; particles.clear();}
+            /// @brief get number of invaders alive in actual wave
+            std::uint32_t getInvadersLeft() const {return control.invaders_left;}
+            /// @brief live invaders, indices in enemies
+            const LiveIndex& getLiveInvaders() const {return live_invaders;}
+            /// @brief live shells, indices in bullets
+            const LiveIndex& getLiveShells() const {return live_shells;}
+            /// @brief live obstacles, indices in obstacles
+            const LiveIndex& getLiveObstacles() const {return live_obstacles;}
+            /// @brief rebuild live lists from visibility of items, used when items are changed
+            /// outside of game logic, for example by network snapshot
+            void rebuildLiveLists();
 
         private:
+            //speeds per tick, no runtime config lookups
+            static constexpr float player_speed     = Config::player_speed/Config::tickrate;
+            static constexpr float enemy_ship_speed = Config::ship_speed/Config::tickrate;
+            static constexpr float invader_speed    = Config::invader_speed/Config::tickrate;
+            static constexpr float shell_speed      = Config::shell_speed/Config::tickrate;
+            static constexpr float tick_duration    = 1.f/Config::tickrate;
+            /// @brief invader path, shared by all invaders
+            static constexpr auto trajectory = makeInvaderTrajectory<Config::trajectory_step_x,Config::trajectory_step_y>();
             /// @brief struct with game control items
             GameControl control;
-            /// @brief struct with game configuration
-            GameConfig config;
+            /// @brief scheduler of delayed game events, see GameTimer
+            TimerWheel timers{static_cast<std::size_t>(GameTimer::Count)};
             /// @brief random number generator instance
             std:: minstd_rand randomizer;
+            /// @brief index of live invaders, used to pick shooters
+            Formation<Config> formation;
+            /// @brief number of shells from which collision detection runs in parallel
+            std::size_t parallel_threshold = Config::parallel_collision_threshold;
+            /// @brief number of background threads of collision detection pool
+            std::size_t collision_threads = ThreadPool::defaultThreads();
+            /// @brief live invaders, updated with their visibility
+            LiveIndex live_invaders;
+            /// @brief live shells, dead ones are reused on next shot
+            LiveIndex live_shells;
+            /// @brief live obstacles, updated with their visibility
+            LiveIndex live_obstacles;
+            /// @brief hardware counters, nullptr if disabled
+            PerfCounters* perf = nullptr;
+            /// @brief explosion particles are emitted and updated
+            bool effects = true;
+            /// @brief thread pool for collision detection, created on demand
+            std::unique_ptr<ThreadPool> pool;
+            /// @brief contact buffer of every pool worker, merged before resolve
+            std::vector<std::vector<Contact>> worker_contacts;
+            /// @brief push event to event bus, event is dropped if nobody drains the bus
+            /// @param type event type
+            /// @param value event payload
+            void emit(GameEventType type, std::int32_t value = 0){events.push(GameEvent{type,value});}
+            /// @brief schedule game timer, pending timer is rescheduled
+            /// @param timer game timer
+            /// @param delay number of ticks until expiry
+            void schedule(GameTimer timer, std::uint64_t delay){timers.schedule(static_cast<std::uint32_t>(timer),delay);}
+            /// @brief remove shell from the canvas
+            /// @param index shell index in bullets
+            void removeShell(std::uint32_t index);
+            /// @brief emit explosion debris in the center of item, skipped if effects are disabled
+            /// @param rectangle item rectangle
+            /// @param count number of particles
+            /// @param color particles color
+            void emitDebris(const sf::FloatRect& rectangle, std::size_t count, const sf::Color& color);
+            /// @brief handler for expired game timer
+            /// @param timer game timer
+            void handleTimer(GameTimer timer);
             /// @brief restart game, setup all game elements to initial state
             void gameRestart();
             /// @brief setup invader instances
@@ -169,6 +257,16 @@ namespace si
             void controlItemsPosition();
             /// @brief check for collision between sprites on the canvas
             void checkCollision();
+            /// @brief find all contacts of shells with targets, does not change game state
+            /// @param first position of first tested shell in live shells list
+            /// @param last position after last tested shell in live shells list
+            /// @param contacts destination list, contacts are appended
+            template<class List>
+            void detectContacts(std::size_t first, std::size_t last, List& contacts) const;
+            /// @brief apply contacts in stable order: by time, then by shell, target type and target,
+            /// each shell and each target is hit only once
+            /// @param contacts list of contacts, sorted in place
+            void resolveContacts(ContactList& contacts);
             /// @brief game event generator
             void generateGameEvent();
             /// @brief handler for player hitting by invader event
@@ -180,6 +278,10 @@ namespace si
             /// @param shell player shell that hit the invader
             /// @param invader invader that was hit
             void handleInvaderHit(Shell& shell, Invader& invader);
+            /// @brief handler for obstacle hitting by any shell
+            /// @param shell shell that hit the obstacle
+            /// @param obstacle obstacle that was hit
+            void handleObstacleHit(Shell& shell, Obstacle& obstacle);
             /// @brief spawn invader ship on the canvas
             void spawnInvaderShip();
             /// @brief generate a new shell on the canvas
@@ -187,6 +289,13 @@ namespace si
             /// @param shell_type shell type (who shot this shell)
             void objectShot(const sf::FloatRect& rectangle, const ShellType shell_type);    
     };
+
+    /// @brief original game
+    using Game          = BasicGame<ClassicConfig>;
+    /// @brief dense formation with rapid fire
+    using StressGame    = BasicGame<StressConfig>;
+    /// @brief classic game with finer ticks
+    using BenchmarkGame = BasicGame<BenchmarkConfig>;
 }      
 
 #endif //GAME_H
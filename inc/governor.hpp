@@ -0,0 +1,80 @@
+/**
+ * @file governor.hpp
+ *
+ * @brief frame budget governor, sheds optional work when frames run over budget
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+////////////////////////////GOVERNOR SETTINGS///////////////////////////////////
+//number of frames in one decision window
+constexpr int       governor_window        = 30;
+//work is shed if at least this number of frames in window is over budget
+constexpr int       governor_shed_frames   = 5;
+//work is restored if worst frame in window takes less than this part of budget
+constexpr float     governor_restore_ratio = 0.6f;
+//number of quality levels, level 0 runs all optional work
+constexpr int       governor_levels        = 4;
+//HUD text is rebuilt at most once per this number of frames on shedding levels
+constexpr unsigned  governor_hud_period    = 15;
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameGovernor
+{
+    public:
+        using clock = std::chrono::steady_clock;
+        /// @brief default constructor
+        /// @param framerate expected framerate, frame budget is one frame period
+        /// @param log stream for governor decisions, one line per decision window, nullptr to
+        /// decide silently
+        explicit FrameGovernor(const unsigned int framerate, std::ostream* log = nullptr);
+        /// @brief add frame work time, level is changed at the end of decision window
+        /// @param work_time time of frame without waiting for the next frame
+        void recordFrame(clock::duration work_time);
+        /// @brief get actual quality level
+        /// @return 0 for full quality, higher levels shed more work
+        int getLevel() const {return level;}
+        /// @brief get part of explosion particles that shall be emitted
+        /// @return value from 0 to 1
+        float getParticleDensity() const;
+        /// @brief get minimal number of frames between HUD text rebuilds
+        /// @return number of frames, 1 to rebuild on every change
+        unsigned int getHudRefreshPeriod() const;
+        /// @brief print frames spent on every level and number of level changes
+        /// @param stream output stream
+        void printStatistics(std::ostream& stream) const;
+
+    private:
+        /// @brief frame budget
+        clock::duration budget;
+        /// @brief stream for decisions, nullptr if decisions are not logged
+        std::ostream* log;
+        /// @brief actual quality level
+        int level = 0;
+        /// @brief number of recorded frames
+        std::uint64_t frames = 0;
+        /// @brief frames recorded in actual window
+        int window_frames = 0;
+        /// @brief frames over budget in actual window
+        int window_over = 0;
+        /// @brief worst frame in actual window
+        clock::duration window_worst = clock::duration::zero();
+        /// @brief number of frames spent on every level
+        std::array<std::uint64_t,governor_levels> level_frames{};
+        /// @brief number of level changes
+        std::uint64_t level_changes = 0;
+        /// @brief log decision of actual window, shed, restore or hold
+        /// @param next level for the next window
+        void logDecision(int next) const;
+};
+
+#endif //GOVERNOR_H
@@ -0,0 +1,24 @@
+/**
+ * @file headless.hpp
+ *
+ * @brief game setup without window and graphics context
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "game.hpp"
+
+namespace si
+{
+    /// @brief setup item sizes from texture images without creating textures,
+    /// collision logic of the game depends on sprite rectangles only, explosion particles are disabled
+    /// @param game reference to game instance of any variant
+    template<class GameType>
+    void setupHeadlessItems(GameType& game);
+}
+
+#endif //HEADLESS_H
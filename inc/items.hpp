@@ -10,6 +10,7 @@
 #ifndef ITEMS_H
 #define ITEMS_H
 
+#include <cstdint>
 #include "object.hpp"
 
 enum class ShellType
@@ -18,6 +19,13 @@ enum class ShellType
     Player
 };
 
+/// @brief invader displacement during one tick in units of its speed
+struct TrajectoryStep
+{
+    std::int8_t x;
+    std::int8_t y;
+};
+
 enum class ItemDirection
 {
     Left,
@@ -34,7 +42,13 @@ class Invader : public Object
         /// @param speed object speed on canvas
         /// @param visible object visibility on canvas
         Invader(sf::Vector2f position, float speed, bool visible);
-        /// @brief change object position according to internal trajectory function
+        /// @brief invisible invader, used for fixed size storage
+        Invader() : Invader(sf::Vector2f(0.f,0.f),0.f,false){}
+        /// @brief setup trajectory table, invader returns to default position after last step
+        /// @param steps pointer to table with one step per tick, shall outlive the invader
+        /// @param length number of steps in table
+        void setTrajectory(const TrajectoryStep* steps, int length){trajectory = steps; trajectory_length = length;}
+        /// @brief change object position according to trajectory table
         void updatePosition();
         /// @brief setup default position and set position_counter to 0
         void revertPosition();
@@ -42,6 +56,10 @@ class Invader : public Object
     private:
         /// @brief actual position counter, used in updatePosition
         int position_counter = 0;
+        /// @brief trajectory table
+        const TrajectoryStep* trajectory = nullptr;
+        /// @brief number of steps in trajectory table
+        int trajectory_length = 0;
 };
 
 class InvaderShip : public Object
@@ -77,6 +95,9 @@ class Shell : public Object
         /// @brief check instance shell type
         /// @return enum class with ShellTypes
         ShellType getShellType() const {return shell_type;};
+        /// @brief get shell displacement during one tick
+        /// @return motion vector that will be applied in updatePosition
+        sf::Vector2f getVelocity() const;
         /// @brief change object position according to internal trajectory function
         void updatePosition();
     
@@ -117,6 +138,8 @@ class Obstacle : public Object
         /// @brief default constructor
         /// @param position initial coordinates 
         Obstacle(sf::Vector2f position);    
+        /// @brief obstacle at the origin, used for fixed size storage
+        Obstacle() : Obstacle(sf::Vector2f(0.f,0.f)){}
 };
 
 #endif //ITEMS_H
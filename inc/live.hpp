@@ -0,0 +1,74 @@
+/**
+ * @file live.hpp
+ *
+ * @brief dense index of live entities with O(1) spawn and death
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef LIVE_H
+#define LIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace si
+{
+    /// @brief permutation of entity indices, live indices are stored first and dead ones after them,
+    /// entity changes its state by swap with the border element
+    class LiveIndex
+    {
+        public:
+            /// @brief add entities up to capacity, added entities are dead, smaller capacity is ignored
+            /// @param capacity new number of entities
+            void resize(std::size_t capacity);
+            /// @brief reserve storage, following resize up to capacity does not allocate
+            /// @param capacity expected number of entities
+            void reserve(std::size_t capacity){dense.reserve(capacity); position.reserve(capacity);}
+            /// @brief mark entity as live, does nothing if it is live already
+            /// @param index entity index
+            void revive(std::uint32_t index);
+            /// @brief mark entity as dead, does nothing if it is dead already
+            /// @param index entity index
+            void kill(std::uint32_t index);
+            /// @brief mark all entities as live
+            void reviveAll(){live = dense.size();}
+            /// @brief mark all entities as dead
+            void killAll(){live = 0;}
+            /// @brief check entity state
+            /// @param index entity index
+            /// @return true if entity is live
+            bool isLive(std::uint32_t index) const {return position[index] < live;}
+            /// @brief get number of live entities
+            /// @return number of live entities
+            std::size_t size() const {return live;}
+            /// @brief get number of all entities
+            /// @return number of entities
+            std::size_t capacity() const {return dense.size();}
+            /// @brief get any dead entity, live entity is returned if all of them are live
+            /// @return entity index
+            std::uint32_t getDead() const {return dense[live];}
+            /// @brief get live entity by its position in the list, order changes on every kill
+            /// @param slot position in range [0, size())
+            /// @return entity index
+            std::uint32_t operator[](std::size_t slot) const {return dense[slot];}
+            /// @brief first live entity
+            const std::uint32_t* begin() const {return dense.data();}
+            /// @brief end of live entities
+            const std::uint32_t* end() const {return dense.data() + live;}
+
+        private:
+            /// @brief live entities followed by dead ones
+            std::vector<std::uint32_t> dense;
+            /// @brief position of every entity in dense
+            std::vector<std::size_t> position;
+            /// @brief number of live entities
+            std::size_t live = 0;
+            /// @brief swap two positions in dense
+            void swap(std::size_t a, std::size_t b);
+    };
+}
+
+#endif //LIVE_H
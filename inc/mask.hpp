@@ -0,0 +1,50 @@
+/**
+ * @file mask.hpp
+ *
+ * @brief 1-bit collision masks built from texture alpha channel
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef MASK_H
+#define MASK_H
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+namespace si
+{
+    ////////////////////////MASK SETTINGS///////////////////////////////////////////
+    //pixels with alpha above this value are solid
+    constexpr std::uint8_t mask_alpha_threshold = 127;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class CollisionMask
+    {
+        public:
+            /// @brief default constructor, empty mask
+            CollisionMask() = default;
+            /// @brief build mask from image alpha channel
+            /// @param image source image
+            explicit CollisionMask(const sf::Image& image);
+            /// @brief find first row with solid pixels inside area
+            /// @param area area in mask coordinates, clipped by mask size
+            /// @param from_bottom scan rows from the bottom of area if true, from the top otherwise
+            /// @return row index or -1 if area has no solid pixels
+            int findRow(const sf::IntRect& area, bool from_bottom) const;
+
+        private:
+            /// @brief mask width in pixels
+            int width = 0;
+            /// @brief mask height in pixels
+            int height = 0;
+            /// @brief number of 64-bit words in one row
+            int words_per_row = 0;
+            /// @brief mask bits row by row, pixel x of row is bit x % 64 of word x / 64
+            std::vector<std::uint64_t> bits;
+    };
+}
+
+#endif //MASK_H
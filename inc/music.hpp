@@ -0,0 +1,254 @@
+/**
+ * @file music.hpp
+ *
+ * @brief background music streamed from compressed tracks by decode thread
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef MUSIC_H
+#define MUSIC_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include "events.hpp"
+#include "game.hpp"
+
+namespace si
+{
+    ////////////////////////MUSIC SETTINGS//////////////////////////////////////////
+    //output is always stereo, mono tracks are duplicated to both channels
+    constexpr unsigned int music_channels = 2;
+    //decoded audio between decode thread and audio output, ring size is rounded down to power
+    //of two samples, track change is heard after this delay
+    constexpr float music_ring_s = 0.25f;
+    //samples decoded and mixed at once, ring holds at least two blocks
+    constexpr std::size_t music_block_samples = 1024;
+    //audio passed to audio device at once, SFML keeps three chunks queued
+    constexpr float music_chunk_s = 0.04f;
+    //length of crossfade between tracks
+    constexpr float music_crossfade_s = 1.5f;
+    //decode thread sleep when ring is full
+    constexpr int music_idle_period_ms = 10;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum class MusicTrack : std::size_t
+    {
+        Welcome,
+        Game,
+        GameOver,
+        /// @brief no track, actual track fades out
+        None
+    };
+
+    /// @brief number of music tracks
+    constexpr std::size_t num_of_tracks = static_cast<std::size_t>(MusicTrack::None);
+
+    /// @brief track files in order of MusicTrack
+    extern const std::array<std::string,num_of_tracks> music_files;
+
+    /// @brief decoder of one track, used by decode thread only
+    class MusicSource
+    {
+        public:
+            virtual ~MusicSource() = default;
+            /// @brief read interleaved samples
+            /// @param samples destination samples
+            /// @param count maximal number of samples
+            /// @return number of read samples, zero at the end of track
+            virtual std::size_t read(std::int16_t* samples, std::size_t count) = 0;
+            /// @brief continue from the beginning of track
+            virtual void rewind() = 0;
+            /// @brief get number of interleaved channels
+            virtual unsigned int getChannelCount() const = 0;
+            /// @brief get number of sample frames per second
+            virtual unsigned int getSampleRate() const = 0;
+    };
+
+    /// @brief track decoded from file, only headers are read on open
+    class FileMusicSource : public MusicSource
+    {
+        public:
+            /// @brief default constructor, throws if file can not be opened
+            /// @param path track file
+            explicit FileMusicSource(const std::string& path);
+            std::size_t read(std::int16_t* samples, std::size_t count) override;
+            void rewind() override {file.seek(sf::Uint64(0));}
+            unsigned int getChannelCount() const override {return file.getChannelCount();}
+            unsigned int getSampleRate() const override {return file.getSampleRate();}
+
+        private:
+            /// @brief decoder of track file
+            sf::InputSoundFile file;
+    };
+
+    /// @brief sources of all tracks in order of MusicTrack
+    using MusicSources = std::array<std::unique_ptr<MusicSource>,num_of_tracks>;
+
+    /// @brief open track files
+    /// @param files track files in order of MusicTrack
+    /// @return sources of all tracks
+    MusicSources openMusicFiles(const std::array<std::string,num_of_tracks>& files = music_files);
+
+    /// @brief get music track for game screen
+    /// @param status actual game status
+    /// @return track that shall be played
+    MusicTrack getMusicTrack(GameStatus status);
+
+    /// @brief single producer single consumer ring of audio samples, read and write never wait
+    class SampleRing
+    {
+        public:
+            /// @brief allocate storage, called once before producer and consumer start
+            /// @param capacity number of samples, shall be power of two
+            void allocate(std::size_t capacity);
+            /// @brief write samples, called by producer thread only
+            /// @param samples source samples
+            /// @param count number of samples
+            /// @return number of written samples, less than count if ring is full
+            std::size_t write(const std::int16_t* samples, std::size_t count);
+            /// @brief read samples, called by consumer thread only
+            /// @param samples destination samples
+            /// @param count number of samples
+            /// @return number of read samples, less than count if ring is empty
+            std::size_t read(std::int16_t* samples, std::size_t count);
+            /// @brief get free space, exact for producer thread
+            /// @return number of samples that can be written
+            std::size_t getSpace() const;
+            /// @brief get number of samples the ring can hold
+            std::size_t getCapacity() const {return samples.size();}
+
+        private:
+            /// @brief capacity minus one, position in storage is masked with it
+            std::size_t mask = 0;
+            /// @brief next sample to write, changed by producer
+            alignas(cache_line_size) std::atomic<std::size_t> head{0};
+            /// @brief next sample to read, changed by consumer
+            alignas(cache_line_size) std::atomic<std::size_t> tail{0};
+            /// @brief ring storage
+            std::vector<std::int16_t> samples;
+    };
+
+    /// @brief music player, tracks are decoded and crossfaded by own thread, memory use
+    /// does not depend on track length
+    class MusicStream
+    {
+        public:
+            /// @brief start decode thread
+            /// @param sources sources in order of MusicTrack, all tracks shall have same sample rate
+            explicit MusicStream(MusicSources sources = openMusicFiles());
+            ~MusicStream();
+            MusicStream(const MusicStream&) = delete;
+            MusicStream& operator=(const MusicStream&) = delete;
+            /// @brief request track, previous track fades out while new one fades in from the beginning,
+            /// called by owner thread
+            /// @param track requested track
+            void setTrack(MusicTrack track){requested.store(track,std::memory_order_relaxed);}
+            /// @brief read mixed samples, missing samples are filled with silence, called by output thread
+            /// @param samples destination samples
+            /// @param count number of samples
+            void read(std::int16_t* samples, std::size_t count);
+            /// @brief get sample rate of all tracks
+            unsigned int getSampleRate() const {return sample_rate;}
+            /// @brief get number of samples buffered between decode thread and output at most
+            std::size_t getRingCapacity() const {return ring.getCapacity();}
+            /// @brief get number of reads that were not filled completely
+            std::uint64_t getUnderruns() const {return underruns.load(std::memory_order_relaxed);}
+
+        private:
+            /// @brief track playing with its own gain
+            struct Voice
+            {
+                /// @brief track, None if voice is free
+                MusicTrack track = MusicTrack::None;
+                /// @brief actual gain from 0 to 1
+                float gain = 0.f;
+                /// @brief gain change per sample frame, negative for fade out
+                float step = 0.f;
+            };
+            /// @brief decoders of all tracks, used by decode thread only
+            MusicSources sources;
+            /// @brief sample rate of all tracks
+            unsigned int sample_rate = 0;
+            /// @brief voices of crossfade, used by decode thread only
+            std::array<Voice,2> voices;
+            /// @brief track decoded from file
+            std::vector<std::int16_t> decoded;
+            /// @brief mix of voices
+            std::vector<std::int32_t> mixed;
+            /// @brief mixed samples ready for output
+            std::vector<std::int16_t> block;
+            /// @brief mixed samples waiting for output
+            SampleRing ring;
+            /// @brief track requested by owner
+            std::atomic<MusicTrack> requested{MusicTrack::None};
+            /// @brief number of incomplete reads
+            std::atomic<std::uint64_t> underruns{0};
+            /// @brief flag to stop decode thread
+            std::atomic<bool> running{true};
+            /// @brief decode thread
+            std::thread thread;
+            /// @brief decode thread function
+            void decodeLoop();
+            /// @brief start fades if requested track differs from actual one
+            /// @param track requested track
+            void switchTrack(MusicTrack track);
+            /// @brief decode and mix one block of every audible voice
+            /// @param frames number of sample frames
+            void mixBlock(std::size_t frames);
+    };
+
+    /// @brief music output to audio device
+    class MusicOutput : public sf::SoundStream
+    {
+        public:
+            /// @brief default constructor
+            /// @param stream music source, shall live longer than output
+            explicit MusicOutput(MusicStream& stream);
+            ~MusicOutput();
+
+        private:
+            /// @brief music source
+            MusicStream& stream;
+            /// @brief samples passed to audio device, sized by music_chunk_s
+            std::vector<std::int16_t> chunk;
+            /// @brief called by SFML audio thread
+            bool onGetData(Chunk& data) override;
+            /// @brief seeking is not supported, tracks follow game screens
+            void onSeek(sf::Time) override {}
+    };
+
+    /// @brief music output that discards samples, used without audio device
+    class NullMusicOutput
+    {
+        public:
+            /// @brief default constructor
+            /// @param stream music source
+            explicit NullMusicOutput(MusicStream& stream): stream(stream) {}
+            /// @brief consume samples for given time
+            /// @param seconds played time
+            void consume(float seconds);
+            /// @brief get number of consumed samples
+            std::uint64_t getConsumed() const {return consumed;}
+
+        private:
+            /// @brief music source
+            MusicStream& stream;
+            /// @brief discarded samples
+            std::array<std::int16_t,music_block_samples> chunk{};
+            /// @brief fraction of sample frame not consumed by previous call
+            float remainder = 0.f;
+            /// @brief number of consumed samples
+            std::uint64_t consumed = 0;
+    };
+}
+
+#endif //MUSIC_H
@@ -0,0 +1,239 @@
+/**
+ * @file network.hpp
+ *
+ * @brief headless authoritative server and snapshot client
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <SFML/Network.hpp>
+#include "game.hpp"
+
+namespace si
+{
+    ////////////////////////NETWORK SETTINGS////////////////////////////////////////
+    constexpr unsigned short default_server_port = 54000;
+    //number of snapshots kept as possible delta baselines
+    constexpr std::uint32_t snapshot_history_size = 64;
+    //client is removed if nothing was received from it during this time
+    constexpr int client_timeout_s = 5;
+    //period of server statistics output
+    constexpr int server_stats_period_s = 5;
+    //positions are sent as fixed point numbers with this scale
+    constexpr float position_scale = 16.f;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum class MessageType : std::uint8_t
+    {
+        Input,
+        Snapshot
+    };
+
+    struct EntityState
+    {
+        /// @brief quantized x coordinate
+        std::int16_t x = 0;
+        /// @brief quantized y coordinate
+        std::int16_t y = 0;
+        /// @brief entity visibility
+        bool visible = false;
+    };
+
+    struct Snapshot
+    {
+        /// @brief snapshot sequence number, 0 is reserved for "no snapshot"
+        std::uint32_t id = 0;
+        /// @brief actual game status
+        std::uint8_t status = 0;
+        /// @brief actual game score
+        std::int32_t score = 0;
+        /// @brief actual number of player lives
+        std::int32_t player_lives = 0;
+        /// @brief entity states in order: player, invader ship, invaders, obstacles, shells
+        std::vector<EntityState> entities;
+    };
+
+    class SnapshotHistory
+    {
+        public:
+            /// @brief get slot for new snapshot, oldest snapshot is overwritten
+            /// @param id sequence number of new snapshot
+            /// @return reference to snapshot slot
+            Snapshot& insert(std::uint32_t id);
+            /// @brief find snapshot by sequence number
+            /// @param id sequence number
+            /// @return pointer to snapshot or nullptr if it is not in history anymore
+            const Snapshot* find(std::uint32_t id) const;
+
+        private:
+            /// @brief ring with last snapshots
+            std::array<Snapshot,snapshot_history_size> ring;
+    };
+
+    /// @brief copy actual game state into snapshot
+    /// @param game game instance
+    /// @param snapshot destination snapshot, entity vector capacity is reused
+    void captureSnapshot(const Game& game, Snapshot& snapshot);
+    /// @brief setup game items according to snapshot
+    /// @param snapshot source snapshot
+    /// @param game game instance used for rendering only
+    void applySnapshot(const Snapshot& snapshot, Game& game);
+    /// @brief write snapshot into packet as delta against baseline
+    /// @param snapshot actual snapshot
+    /// @param baseline snapshot acknowledged by receiver or nullptr for full snapshot
+    /// @param packet destination packet
+    void encodeSnapshot(const Snapshot& snapshot, const Snapshot* baseline, sf::Packet& packet);
+    /// @brief read snapshot from packet, message type is already extracted
+    /// @param packet source packet
+    /// @param history history with possible baselines
+    /// @param snapshot destination snapshot
+    /// @return false if packet is broken or baseline is unknown
+    bool decodeSnapshot(sf::Packet& packet, const SnapshotHistory& history, Snapshot& snapshot);
+
+    struct ClientInput
+    {
+        /// @brief last snapshot received by client
+        std::uint32_t acked_snapshot = 0;
+        /// @brief left key is pressed
+        bool left = false;
+        /// @brief right key is pressed
+        bool right = false;
+        /// @brief client leaves the game
+        bool disconnect = false;
+        /// @brief total number of space key presses, robust to packet loss
+        std::uint32_t space_presses = 0;
+    };
+
+    struct ServerStatistics
+    {
+        /// @brief number of connected clients
+        std::size_t clients = 0;
+        /// @brief sent bytes per tick, all clients
+        std::uint64_t bytes_per_tick = 0;
+        /// @brief sent bytes per tick and client
+        std::uint64_t bytes_per_tick_client = 0;
+        /// @brief number of sent snapshots
+        std::uint64_t snapshots = 0;
+        /// @brief number of snapshots encoded as delta against baseline acknowledged by client
+        std::uint64_t delta_snapshots = 0;
+    };
+
+    class Server
+    {
+        public:
+            /// @brief default constructor
+            /// @param port UDP port for incoming client inputs
+            Server(unsigned short port);
+            /// @brief run simulation loop
+            /// @param ticks number of ticks to run, 0 to run forever
+            void run(std::uint64_t ticks = 0);
+            /// @brief get statistics of last output period
+            /// @return reference to statistics, updated together with statistics output
+            const ServerStatistics& getStatistics() const {return statistics;}
+
+        private:
+            using clock = std::chrono::steady_clock;
+
+            struct RemoteClient
+            {
+                /// @brief client address
+                sf::IpAddress address;
+                /// @brief client port
+                unsigned short port;
+                /// @brief last received input
+                ClientInput input;
+                /// @brief time of last received input
+                clock::time_point last_seen;
+                /// @brief bytes sent since last statistics output
+                std::uint64_t bytes_sent = 0;
+                /// @brief snapshots sent since last statistics output
+                std::uint64_t snapshots = 0;
+                /// @brief delta snapshots sent since last statistics output
+                std::uint64_t delta_snapshots = 0;
+                /// @brief time spent on this client since last statistics output
+                clock::duration cpu_time = clock::duration::zero();
+            };
+
+            /// @brief UDP socket
+            sf::UdpSocket socket;
+            /// @brief simulation rate
+            unsigned int tickrate;
+            /// @brief authoritative game instance
+            Game game;
+            /// @brief connected clients, first client controls the player ship, others are spectators
+            std::vector<RemoteClient> clients;
+            /// @brief last sent snapshots
+            SnapshotHistory history;
+            /// @brief sequence number of last snapshot
+            std::uint32_t snapshot_id = 0;
+            /// @brief reusable packet for outgoing messages
+            sf::Packet packet;
+            /// @brief statistics of last output period
+            ServerStatistics statistics;
+            /// @brief receive all pending client inputs
+            void receiveInputs();
+            /// @brief translate input of controlling client into game events
+            /// @param previous previous input state
+            /// @param actual actual input state
+            void applyInput(const ClientInput& previous, const ClientInput& actual);
+            /// @brief remove client and pass player control to the next one
+            /// @param index client index in clients vector
+            void removeClient(std::size_t index);
+            /// @brief remove clients that are silent too long
+            void dropSilentClients();
+            /// @brief send actual snapshot to every client
+            void broadcastSnapshot();
+            /// @brief print traffic and CPU usage, reset client counters
+            /// @param ticks number of ticks since last output
+            /// @param simulation_time time spent in simulation since last output
+            void printStatistics(std::uint64_t ticks, clock::duration simulation_time);
+    };
+
+    class Client
+    {
+        public:
+            /// @brief default constructor
+            /// @param address server address
+            /// @param port server port
+            Client(const sf::IpAddress& address, unsigned short port);
+            /// @brief notify server that client leaves
+            ~Client();
+            /// @brief update input state from window event
+            /// @param event reference to actual captured event
+            void handleEvent(const sf::Event& event);
+            /// @brief send input, receive snapshots and apply the newest one
+            /// @param game game instance used for rendering only
+            void update(Game& game);
+            /// @brief get last snapshot received and acknowledged by client
+            /// @return snapshot sequence number, 0 if nothing was received
+            std::uint32_t getAckedSnapshot() const {return input.acked_snapshot;}
+
+        private:
+            /// @brief UDP socket
+            sf::UdpSocket socket;
+            /// @brief server address
+            sf::IpAddress server_address;
+            /// @brief server port
+            unsigned short server_port;
+            /// @brief actual input state
+            ClientInput input;
+            /// @brief received snapshots
+            SnapshotHistory history;
+            /// @brief buffer for snapshot decoding
+            Snapshot received;
+            /// @brief reusable packet for messages
+            sf::Packet packet;
+            /// @brief send actual input state to server
+            void sendInput();
+    };
+}
+
+#endif //NETWORK_H
@@ -12,6 +12,8 @@
 
 #include <SFML/Graphics.hpp>
 
+namespace si{class CollisionMask;}
+
 class Object
 {
     public:
@@ -35,6 +37,9 @@ class Object
         /// @brief change sprite color
         /// @param color new color and transparency level
         void setSpriteColor(const sf::Color& color){sprite.setColor(color);}
+        /// @brief setup pixel collision mask, object is solid rectangle without mask
+        /// @param mask pointer to mask, shall be alive as long as object
+        void setCollisionMask(const si::CollisionMask* mask){this->mask = mask;}
         /// @brief set object visibility
         /// @param visibility visible or not
         void setVisibility(const bool visibility){visible = visibility;}
@@ -49,7 +54,22 @@ class Object
         sf::FloatRect getRectangle() const {return sprite.getGlobalBounds();}
         /// @brief get reference to object sprite
         /// @return reference to sf::Sprite type class member
-        sf::Sprite getSprite() const {return sprite;}
+        const sf::Sprite& getSprite() const {return sprite;}
+        /// @brief get actual object position without copying the sprite
+        /// @return reference to sprite position
+        const sf::Vector2f& getPosition() const {return sprite.getPosition();}
+        /// @brief get sprite texture rectangle without copying the sprite
+        /// @return reference to sprite texture rectangle
+        const sf::IntRect& getTextureRect() const {return sprite.getTextureRect();}
+        /// @brief get sprite color without copying the sprite
+        /// @return reference to sprite color
+        const sf::Color& getColor() const {return sprite.getColor();}
+        /// @brief get sprite texture
+        /// @return pointer to texture or nullptr if texture is not set
+        const sf::Texture* getTexture() const {return sprite.getTexture();}
+        /// @brief get pixel collision mask
+        /// @return pointer to mask or nullptr if object is solid rectangle
+        const si::CollisionMask* getCollisionMask() const {return mask;}
         /// @brief check if object visible or not
         /// @return true if visible false if not
         bool isVisible() const {return visible;}
@@ -62,6 +82,8 @@ class Object
         sf::Sprite sprite;
         /// @brief default object coordinates
         sf::Vector2f def_position;
+        /// @brief pixel collision mask
+        const si::CollisionMask* mask = nullptr;
         /// @brief object state flag, whether it will be displayed in coordinates or not.
         bool visible;
         /// @brief object speed in coordinates per second
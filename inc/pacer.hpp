@@ -0,0 +1,86 @@
+/**
+ * @file pacer.hpp
+ *
+ * @brief frame pacing with coarse sleep and final spin-wait
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef PACER_H
+#define PACER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+//////////////////////////////PACER SETTINGS////////////////////////////////////
+//number of bins in frame-to-frame jitter histogram, last bin collects all outliers
+constexpr int       jitter_histogram_bins = 20;
+//width of one histogram bin in microseconds
+constexpr long long jitter_bin_width_us   = 50;
+//extra time reserved for the spin-wait on top of measured wake-up overshoot
+constexpr long long spin_margin_us        = 200;
+////////////////////////////////////////////////////////////////////////////////
+
+struct JitterHistogram
+{
+    /// @brief number of frames in every bin, bin i holds jitter in [i*width, (i+1)*width) us
+    std::array<std::uint64_t,jitter_histogram_bins> bins{};
+    /// @brief total number of measured frames
+    std::uint64_t frames = 0;
+    /// @brief worst measured jitter in microseconds
+    long long max_jitter_us = 0;
+};
+
+class FramePacer
+{
+    public:
+        using clock = std::chrono::steady_clock;
+        /// @brief default constructor
+        /// @param framerate expected framerate
+        /// @param power_saving if true only coarse sleep is used, without spin-wait
+        FramePacer(const unsigned int framerate, bool power_saving = false);
+        /// @brief block until the beginning of the next frame period
+        void waitForNextFrame();
+        /// @brief enable or disable power-saving mode
+        /// @param state true to skip the spin-wait
+        void setPowerSaving(bool state){power_saving = state;}
+        /// @brief check power-saving mode
+        /// @return true if spin-wait is skipped
+        bool isPowerSaving() const {return power_saving;}
+        /// @brief get collected frame-to-frame jitter statistics
+        /// @return reference to jitter histogram
+        const JitterHistogram& getJitterHistogram() const {return histogram;}
+        /// @brief get actual estimation of OS sleep overshoot
+        /// @return overshoot estimation
+        clock::duration getSleepOvershoot() const {return overshoot;}
+        /// @brief print jitter histogram in human readable form
+        /// @param stream output stream
+        void printStatistics(std::ostream& stream) const;
+
+    private:
+        /// @brief expected frame period
+        clock::duration period;
+        /// @brief deadline of the actual frame
+        clock::time_point deadline;
+        /// @brief time point when previous frame was released
+        clock::time_point last_frame;
+        /// @brief adaptive estimation of how late OS wakes up after sleep
+        clock::duration overshoot;
+        /// @brief power-saving mode flag
+        bool power_saving;
+        /// @brief flag that at least one frame was released
+        bool started = false;
+        /// @brief frame-to-frame jitter statistics
+        JitterHistogram histogram;
+        /// @brief sleep until given time point and update overshoot estimation
+        /// @param wake_up expected wake up time point
+        void coarseSleep(clock::time_point wake_up);
+        /// @brief add frame period to jitter histogram
+        /// @param frame_time measured frame period
+        void recordFrame(clock::duration frame_time);
+};
+
+#endif //PACER_H
@@ -0,0 +1,93 @@
+/**
+ * @file particles.hpp
+ *
+ * @brief particle system for explosions and debris
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+namespace si
+{
+    ////////////////////////PARTICLE SETTINGS///////////////////////////////////////
+    //particle quad size in game coordinates
+    constexpr float particle_size        = 3.f;
+    //particle speed range in coordinates per second
+    constexpr float particle_min_speed   = 50.f;
+    constexpr float particle_max_speed   = 250.f;
+    //particle lifetime range in seconds
+    constexpr float particle_min_life    = 0.3f;
+    constexpr float particle_max_life    = 1.0f;
+    //vertical acceleration of debris
+    constexpr float particle_gravity     = 300.f;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class ParticleSystem : public sf::Drawable
+    {
+        public:
+            /// @brief default constructor, all memory is allocated here
+            /// @param capacity maximum number of live particles
+            explicit ParticleSystem(std::size_t capacity);
+            /// @brief spawn burst of particles, particles over capacity are dropped
+            /// @param position burst center
+            /// @param count number of particles
+            /// @param color particles color
+            void emit(const sf::Vector2f& position, std::size_t count, const sf::Color& color);
+            /// @brief move particles, remove dead ones and rebuild vertices
+            /// @param dt time step in seconds
+            void update(float dt);
+            /// @brief remove all particles
+            void clear(){size = 0;}
+            /// @brief scale number of particles in following bursts
+            /// @param value part of requested particles, from 0 to 1
+            void setDensity(float value){density = value;}
+            /// @brief get number of live particles
+            /// @return number of live particles
+            std::size_t getSize() const {return size;}
+
+        private:
+            /// @brief maximum number of particles, multiple of simd width
+            std::size_t capacity;
+            /// @brief number of live particles
+            std::size_t size = 0;
+            /// @brief part of requested particles that is emitted
+            float density = 1.f;
+            /// @brief particle x coordinates
+            std::vector<float> x;
+            /// @brief particle y coordinates
+            std::vector<float> y;
+            /// @brief particle x velocities
+            std::vector<float> vx;
+            /// @brief particle y velocities
+            std::vector<float> vy;
+            /// @brief particle remaining life in seconds
+            std::vector<float> life;
+            /// @brief inverse of particle initial life, used for fading
+            std::vector<float> inv_life;
+            /// @brief particle colors
+            std::vector<sf::Color> colors;
+            /// @brief quads of live particles
+            std::vector<sf::Vertex> vertices;
+            /// @brief random generator for burst shape
+            std::minstd_rand randomizer;
+            /// @brief simd kernel for position, velocity and life
+            /// @param dt time step in seconds
+            void integrate(float dt);
+            /// @brief swap-remove dead particles
+            void compact();
+            /// @brief rebuild quads of live particles
+            void buildVertices();
+            /// @brief draw all particles with one draw call
+            void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    };
+}
+
+#endif //PARTICLES_H
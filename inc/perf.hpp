@@ -0,0 +1,124 @@
+/**
+ * @file perf.hpp
+ *
+ * @brief optional hardware performance counters per game stage
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace si
+{
+    enum class PerfStage : std::uint8_t
+    {
+        Collision,
+        ItemsUpdate,
+        CanvasUpdate,
+        Count
+    };
+
+    enum class PerfCounter : std::uint8_t
+    {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        Count
+    };
+
+    /// @brief aggregated counter deltas of one stage
+    struct PerfStageTotals
+    {
+        /// @brief number of measured stage runs
+        std::uint64_t samples = 0;
+        /// @brief number of stage runs that were not measured because they used other threads too
+        std::uint64_t skipped = 0;
+        /// @brief sum of counter deltas
+        std::array<std::uint64_t,static_cast<std::size_t>(PerfCounter::Count)> sum{};
+        /// @brief the largest counter delta of one run
+        std::array<std::uint64_t,static_cast<std::size_t>(PerfCounter::Count)> max{};
+    };
+
+    /// @brief group of hardware counters of the calling thread, opened with perf_event_open on Linux,
+    /// all functions do nothing if counters are not available
+    class PerfCounters
+    {
+        public:
+            /// @brief open counters, failure is not an error
+            PerfCounters();
+            ~PerfCounters();
+            PerfCounters(const PerfCounters&) = delete;
+            PerfCounters& operator=(const PerfCounters&) = delete;
+            /// @brief check if at least cycles counter is opened
+            /// @return true if counters are available
+            bool isAvailable() const {return leader >= 0;}
+            /// @brief read counters at stage start
+            void begin();
+            /// @brief read counters at stage end and add deltas to stage totals
+            /// @param stage measured stage
+            void end(PerfStage stage);
+            /// @brief do not add actual stage run to totals, called when stage work runs on other
+            /// threads too, their events are not counted by counters of calling thread
+            void skip(){skip_run = true;}
+            /// @brief get aggregated deltas
+            /// @param stage game stage
+            /// @return stage totals
+            const PerfStageTotals& getTotals(PerfStage stage) const {return totals[static_cast<std::size_t>(stage)];}
+            /// @brief print average and the largest deltas of every stage and number of skipped runs
+            /// @param stream output stream
+            void print(std::ostream& stream) const;
+
+        private:
+            static constexpr std::size_t num_of_counters = static_cast<std::size_t>(PerfCounter::Count);
+            /// @brief group leader descriptor, -1 if counters are not available
+            int leader = -1;
+            /// @brief descriptors of all counters, -1 for counters not supported by the CPU
+            std::array<int,num_of_counters> descriptors;
+            /// @brief position of every counter in group read, -1 if counter is not opened
+            std::array<int,num_of_counters> positions;
+            /// @brief number of opened counters
+            std::size_t opened = 0;
+            /// @brief counter values at stage start
+            std::array<std::uint64_t,num_of_counters> start{};
+            /// @brief actual stage run shall not be added to totals
+            bool skip_run = false;
+            /// @brief aggregated deltas by stage
+            std::array<PerfStageTotals,static_cast<std::size_t>(PerfStage::Count)> totals;
+            /// @brief read all counters of the group
+            /// @param values destination values
+            /// @return true on success
+            bool read(std::array<std::uint64_t,num_of_counters>& values) const;
+    };
+
+    /// @brief measures stage until scope end, does nothing with nullptr counters
+    class PerfScope
+    {
+        public:
+            /// @brief default constructor
+            /// @param counters pointer to counters, may be nullptr
+            /// @param stage measured stage
+            PerfScope(PerfCounters* counters, PerfStage stage) : counters(counters), stage(stage)
+            {
+                if(counters){counters->begin();}
+            }
+            ~PerfScope(){if(counters){counters->end(stage);}}
+            PerfScope(const PerfScope&) = delete;
+            PerfScope& operator=(const PerfScope&) = delete;
+
+        private:
+            /// @brief pointer to counters
+            PerfCounters* counters;
+            /// @brief measured stage
+            PerfStage stage;
+    };
+}
+
+#endif //PERF_H
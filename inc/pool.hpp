@@ -0,0 +1,104 @@
+/**
+ * @file pool.hpp
+ *
+ * @brief work-stealing thread pool for data parallel loops
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace si
+{
+    class ThreadPool
+    {
+        public:
+            /// @brief default constructor
+            /// @param num_of_threads number of background threads, calling thread is used as worker too
+            explicit ThreadPool(std::size_t num_of_threads = defaultThreads());
+            /// @brief stop and join all background threads
+            ~ThreadPool();
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+            /// @brief get number of workers including calling thread
+            /// @return number of workers
+            std::size_t getWorkers() const {return threads.size() + 1;}
+            /// @brief run function over range [0, count) split into chunks, returns when all chunks are done.
+            /// Range is split between workers, worker that finished its part steals chunks from the others.
+            /// @param count range size
+            /// @param grain chunk size
+            /// @param function callable with (worker, first, last) arguments, worker is in [0, getWorkers())
+            template<class Function>
+            void parallelFor(std::size_t count, std::size_t grain, Function&& function);
+            /// @brief default number of background threads
+            /// @return number of hardware threads minus one
+            static std::size_t defaultThreads();
+
+        private:
+            using Invoker = void(*)(void*, std::size_t, std::size_t, std::size_t);
+
+            struct alignas(64) Slice
+            {
+                /// @brief first index of not claimed chunk
+                std::atomic<std::size_t> next{0};
+                /// @brief end of the slice
+                std::size_t end = 0;
+            };
+
+            /// @brief background threads
+            std::vector<std::thread> threads;
+            /// @brief range slice of every worker
+            std::unique_ptr<Slice[]> slices;
+            /// @brief protects job state below
+            std::mutex mutex;
+            /// @brief new job or stop signal
+            std::condition_variable start_signal;
+            /// @brief all background threads finished the job
+            std::condition_variable done_signal;
+            /// @brief job counter, changed for every new job
+            std::uint64_t generation = 0;
+            /// @brief number of background threads still working on the job
+            std::size_t running = 0;
+            /// @brief stop request for background threads
+            bool stop = false;
+            /// @brief type erased job function
+            Invoker invoker = nullptr;
+            /// @brief job function object
+            void* context = nullptr;
+            /// @brief chunk size of actual job
+            std::size_t grain = 1;
+            /// @brief start job and wait until it is done
+            void run(std::size_t count, std::size_t grain, Invoker invoker, void* context);
+            /// @brief process chunks of own slice, then steal chunks of other slices
+            /// @param worker worker index
+            void work(std::size_t worker);
+            /// @brief background thread function
+            /// @param worker worker index
+            void workerLoop(std::size_t worker);
+    };
+
+    template<class Function>
+    void ThreadPool::parallelFor(std::size_t count, std::size_t grain, Function&& function)
+    {
+        using Type = std::remove_reference_t<Function>;
+        auto invoke = [](void* context, std::size_t worker, std::size_t first, std::size_t last)
+        {
+            (*static_cast<Type*>(context))(worker,first,last);
+        };
+        run(count,grain,invoke,const_cast<void*>(static_cast<const void*>(std::addressof(function))));
+    }
+}
+
+#endif //POOL_H
@@ -0,0 +1,162 @@
+/**
+ * @file render.hpp
+ *
+ * @brief render command list with sorted submission to a backend
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "object.hpp"
+
+namespace si
+{
+    ////////////////////////RENDER SETTINGS/////////////////////////////////////////
+    //initial capacity of command list and vertex batch
+    constexpr std::size_t render_commands_reserve = 1024;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum class RenderLayer : std::uint8_t
+    {
+        Menu,
+        Items,
+        Effects,
+        Ships
+    };
+
+    struct RenderCommand
+    {
+        /// @brief draw order group, lower layers are drawn first
+        RenderLayer layer;
+        /// @brief quad texture, can be nullptr
+        const sf::Texture* texture;
+        /// @brief quad texture rectangle
+        sf::IntRect rectangle;
+        /// @brief quad transform
+        sf::Transform transform;
+        /// @brief quad color
+        sf::Color color;
+        /// @brief item that is not a textured quad (text, vertex arrays), nullptr for quads
+        const sf::Drawable* drawable;
+        /// @brief insertion order, keeps sorting stable
+        std::uint32_t sequence;
+    };
+
+    class RenderQueue
+    {
+        public:
+            /// @brief default constructor
+            RenderQueue(){commands.reserve(render_commands_reserve);}
+            /// @brief remove all commands, capacity is kept
+            void clear(){commands.clear();}
+            /// @brief add textured quad of object sprite
+            /// @param layer draw order group
+            /// @param object object to draw
+            void add(RenderLayer layer, const Object& object);
+            /// @brief add textured quad
+            /// @param layer draw order group
+            /// @param sprite sprite with texture, rectangle, transform and color of the quad
+            void add(RenderLayer layer, const sf::Sprite& sprite);
+            /// @brief add item that is drawn on its own
+            /// @param layer draw order group
+            /// @param drawable item to draw, shall be alive until submission
+            void add(RenderLayer layer, const sf::Drawable& drawable);
+            /// @brief sort commands by layer, then by texture, insertion order is kept inside groups
+            void sort();
+            /// @brief get recorded commands
+            /// @return reference to command list
+            const std::vector<RenderCommand>& getCommands() const {return commands;}
+
+        private:
+            /// @brief recorded commands
+            std::vector<RenderCommand> commands;
+    };
+
+    struct RenderStatistics
+    {
+        /// @brief number of submitted commands
+        std::size_t commands = 0;
+        /// @brief number of draw calls
+        std::size_t draw_calls = 0;
+        /// @brief number of texture changes between draw calls
+        std::size_t texture_changes = 0;
+    };
+
+    class RenderBackend
+    {
+        public:
+            RenderBackend(){batch.reserve(render_commands_reserve*4);}
+            virtual ~RenderBackend() = default;
+            /// @brief draw sorted command list, consecutive quads with the same texture are batched in one draw call
+            /// @param queue sorted command list
+            void submit(const RenderQueue& queue);
+            /// @brief get statistics of last submission
+            /// @return reference to statistics
+            const RenderStatistics& getStatistics() const {return statistics;}
+
+        protected:
+            /// @brief draw batch of quads
+            /// @param vertices quad vertices
+            /// @param count number of vertices
+            /// @param texture texture of all quads, can be nullptr
+            virtual void drawQuads(const sf::Vertex* vertices, std::size_t count, const sf::Texture* texture) = 0;
+            /// @brief draw item on its own
+            /// @param drawable item to draw
+            virtual void drawItem(const sf::Drawable& drawable) = 0;
+            /// @brief called before first draw of submission
+            /// @param queue submitted command list
+            virtual void beginFrame(const RenderQueue& queue){(void)queue;}
+
+        private:
+            /// @brief vertices of actual quad batch
+            std::vector<sf::Vertex> batch;
+            /// @brief texture of actual quad batch
+            const sf::Texture* batch_texture = nullptr;
+            /// @brief statistics of last submission
+            RenderStatistics statistics;
+            /// @brief draw actual batch and start a new one
+            void flush();
+    };
+
+    class SfmlBackend : public RenderBackend
+    {
+        public:
+            /// @brief default constructor
+            /// @param target window or offscreen texture
+            explicit SfmlBackend(sf::RenderTarget& target) : target(target){}
+
+        protected:
+            void drawQuads(const sf::Vertex* vertices, std::size_t count, const sf::Texture* texture) override;
+            void drawItem(const sf::Drawable& drawable) override;
+
+        private:
+            /// @brief render target
+            sf::RenderTarget& target;
+    };
+
+    class RecordingBackend : public RenderBackend
+    {
+        public:
+            /// @brief get commands of last frame
+            /// @return reference to recorded commands
+            const std::vector<RenderCommand>& getFrame() const {return frame;}
+
+        protected:
+            void drawQuads(const sf::Vertex*, std::size_t, const sf::Texture*) override {}
+            void drawItem(const sf::Drawable&) override {}
+            void beginFrame(const RenderQueue& queue) override {frame = queue.getCommands();}
+
+        private:
+            /// @brief copy of last submitted commands
+            std::vector<RenderCommand> frame;
+    };
+}
+
+#endif //RENDER_H
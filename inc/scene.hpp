@@ -0,0 +1,54 @@
+/**
+ * @file scene.hpp
+ *
+ * @brief recording of game items and HUD to render queue, shared by canvas and render benchmark
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <array>
+#include "game.hpp"
+#include "render.hpp"
+
+//////////////////////////////SCENE SETTINGS////////////////////////////////////
+constexpr int num_of_frames = 5;
+////////////////////////////////////////////////////////////////////////////////
+
+namespace si
+{
+    struct HudSprites
+    {
+        /// @brief text with game score
+        sf::Text score;
+        /// @brief sprite with player live, moved to every indicator position
+        sf::Sprite live;
+        /// @brief array with canvas frames
+        std::array<Object,num_of_frames> frames;
+    };
+
+    /// @brief record live invaders, shells, obstacles, debris and ships, HUD is not recorded
+    /// @param queue destination command list
+    /// @param game reference to game instance of any variant
+    template<class GameType>
+    void recordGameItems(RenderQueue& queue, const GameType& game);
+
+    /// @brief set font, textures and positions of HUD, score string is set by caller
+    /// @param hud HUD sprites
+    /// @param font score font
+    /// @param character_size score character size
+    /// @param player texture of lives indicator
+    /// @param frame texture of canvas frames
+    void setupHud(HudSprites& hud, const sf::Font& font, unsigned int character_size, const sf::Texture& player, const sf::Texture& frame);
+
+    /// @brief record score, lives indicator and canvas frames drawn over game screen
+    /// @param queue destination command list
+    /// @param hud HUD sprites, lives sprite is moved while recording
+    /// @param lives number of shown player lives
+    void recordHud(RenderQueue& queue, HudSprites& hud, int lives);
+}
+
+#endif //SCENE_H
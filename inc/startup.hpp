@@ -0,0 +1,49 @@
+/**
+ * @file startup.hpp
+ *
+ * @brief startup phase timestamps
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+//////////////////////////////STARTUP SETTINGS//////////////////////////////////
+constexpr std::size_t max_startup_phases = 16;
+////////////////////////////////////////////////////////////////////////////////
+
+class StartupTimeline
+{
+    public:
+        using clock = std::chrono::steady_clock;
+        /// @brief default constructor
+        /// @param start time point of application start
+        explicit StartupTimeline(clock::time_point start = clock::now()) : start(start), last(start){}
+        /// @brief finish phase that started at previous mark
+        /// @param phase phase name, shall be string literal
+        void mark(const char* phase);
+        /// @brief print duration of every phase and total time
+        /// @param stream output stream
+        void print(std::ostream& stream) const;
+
+    private:
+        /// @brief application start
+        clock::time_point start;
+        /// @brief previous mark
+        clock::time_point last;
+        /// @brief phase names
+        std::array<const char*,max_startup_phases> names{};
+        /// @brief phase durations
+        std::array<clock::duration,max_startup_phases> durations{};
+        /// @brief number of recorded phases
+        std::size_t count = 0;
+};
+
+#endif //STARTUP_H
@@ -0,0 +1,109 @@
+/**
+ * @file timers.hpp
+ *
+ * @brief hierarchical timer wheel for tick based game events
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace si
+{
+    ////////////////////////TIMERS SETTINGS/////////////////////////////////////////
+    //wheel levels and slots per level, delays up to 64^4 ticks are exact
+    constexpr std::size_t timer_wheel_levels = 4;
+    constexpr std::size_t timer_slot_bits    = 6;
+    constexpr std::size_t timer_wheel_slots  = std::size_t(1) << timer_slot_bits;
+    ////////////////////////////////////////////////////////////////////////////////
+
+    /// @brief timers are identified by index in range [0, capacity), every timer is pending
+    /// at most once, schedule, cancel and expiry are O(1), timers of higher levels are moved
+    /// down once per level
+    class TimerWheel
+    {
+        public:
+            /// @brief default constructor
+            /// @param capacity number of timer identifiers, all memory is allocated here
+            explicit TimerWheel(std::size_t capacity);
+            /// @brief schedule timer, pending timer is rescheduled
+            /// @param id timer identifier
+            /// @param delay number of ticks until expiry, 0 is treated as 1
+            void schedule(std::uint32_t id, std::uint64_t delay);
+            /// @brief cancel timer, does nothing if timer is not pending
+            /// @param id timer identifier
+            void cancel(std::uint32_t id);
+            /// @brief cancel all pending timers
+            void cancelAll();
+            /// @brief check if timer is pending
+            /// @param id timer identifier
+            /// @return true if timer is scheduled and not expired yet
+            bool isPending(std::uint32_t id) const {return nodes[id].pending;}
+            /// @brief move time one tick forward and call callback for every expired timer,
+            /// callback may schedule and cancel timers
+            /// @param callback function with timer identifier argument
+            template<class Callback>
+            void advance(Callback callback);
+
+        private:
+            static constexpr std::uint32_t none = UINT32_MAX;
+            static constexpr std::uint64_t slot_mask = timer_wheel_slots - 1;
+            struct Node
+            {
+                /// @brief tick of expiry
+                std::uint64_t expiry = 0;
+                /// @brief next timer in slot list
+                std::uint32_t next = none;
+                /// @brief previous timer in slot list
+                std::uint32_t previous = none;
+                /// @brief slot list index
+                std::uint32_t slot = 0;
+                /// @brief timer is linked in slot list
+                bool pending = false;
+            };
+            /// @brief actual tick
+            std::uint64_t now = 0;
+            /// @brief timer nodes by identifier
+            std::vector<Node> nodes;
+            /// @brief first timer of every slot, level by level
+            std::array<std::uint32_t,timer_wheel_levels*timer_wheel_slots> slots;
+            /// @brief link timer to slot selected by its expiry
+            /// @param id timer identifier
+            void link(std::uint32_t id);
+            /// @brief remove timer from its slot
+            /// @param id timer identifier
+            void unlink(std::uint32_t id);
+            /// @brief move timers of the higher level slot to lower levels
+            /// @param level wheel level, not 0
+            /// @param slot slot number in level
+            void cascade(std::size_t level, std::size_t slot);
+    };
+
+    template<class Callback>
+    void TimerWheel::advance(Callback callback)
+    {
+        ++now;
+        //higher level slot is due when all lower level bits wrap
+        for(std::size_t level = 1; level < timer_wheel_levels; ++level)
+        {
+            if(((now >> (timer_slot_bits*(level - 1))) & slot_mask) != 0){break;}
+            cascade(level,(now >> (timer_slot_bits*level)) & slot_mask);
+        }
+        std::uint32_t& head = slots[now & slot_mask];
+        while(head != none)
+        {
+            const auto id = head;
+            unlink(id);
+            callback(id);
+        }
+    }
+}
+
+#endif //TIMERS_H
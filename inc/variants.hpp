@@ -0,0 +1,92 @@
+/**
+ * @file variants.hpp
+ *
+ * @brief compile-time configurations of game variants
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef VARIANTS_H
+#define VARIANTS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "items.hpp"
+
+namespace si
+{
+    /// @brief build invader trajectory table, one step per tick
+    //  StepX steps
+    // ---------->
+    // |         |
+    // |         | StepY steps
+    // <---------|
+    template<int StepX, int StepY>
+    constexpr std::array<TrajectoryStep,2*(StepX + StepY)> makeInvaderTrajectory()
+    {
+        std::array<TrajectoryStep,2*(StepX + StepY)> table{};
+        for(auto i = 0; i < 2*(StepX + StepY); ++i)
+        {
+            if(i < StepX)                  {table[i] = TrajectoryStep{1,0};}
+            else if(i < StepX + StepY)     {table[i] = TrajectoryStep{0,1};}
+            else if(i < 2*StepX + StepY)   {table[i] = TrajectoryStep{-1,0};}
+            else                           {table[i] = TrajectoryStep{0,-1};}
+        }
+        return table;
+    }
+
+    /// @brief original game, speeds are in pixels per second, periods in ticks
+    struct ClassicConfig
+    {
+        static constexpr unsigned int tickrate           = 60;
+        static constexpr int   invaders_in_row           = 10;
+        static constexpr int   rows_with_invaders        = 6;
+        //max 10 items per one row
+        static constexpr float grid_step                 = 1000.f/15.f;
+        static constexpr float invader_speed             = 30.f;
+        static constexpr float ship_speed                = 100.f;
+        static constexpr float shell_speed               = 200.f;
+        static constexpr float player_speed              = 400.f;
+        static constexpr std::uint32_t invader_shot_period  = tickrate;
+        static constexpr std::uint32_t ship_spawn_period    = tickrate*15;
+        static constexpr std::uint32_t player_reload_period = tickrate/4;
+        static constexpr std::uint32_t wave_respawn_delay   = tickrate*3;
+        static constexpr int   trajectory_step_x         = 450;
+        static constexpr int   trajectory_step_y         = 20;
+        //shells vector capacity reserved at start, prevents reallocation during the game
+        static constexpr std::size_t shells_reserve      = 64;
+        //collision detection runs on thread pool when number of shells is not less than this value
+        static constexpr std::size_t parallel_collision_threshold = 2048;
+        //maximum number of live explosion particles, particles live up to 1 s
+        static constexpr std::size_t particle_capacity   = 4096;
+    };
+
+    /// @brief dense formation with rapid fire, used for load generation
+    struct StressConfig : ClassicConfig
+    {
+        static constexpr int   invaders_in_row           = 16;
+        static constexpr int   rows_with_invaders        = 10;
+        static constexpr float grid_step                 = 40.f;
+        static constexpr std::uint32_t invader_shot_period  = tickrate/10;
+        static constexpr std::uint32_t ship_spawn_period    = tickrate*5;
+        static constexpr std::size_t shells_reserve      = 512;
+        static constexpr std::size_t parallel_collision_threshold = 256;
+        static constexpr std::size_t particle_capacity   = 8192;
+    };
+
+    /// @brief classic game simulated with 4 times finer ticks, same trajectories on canvas
+    struct BenchmarkConfig : ClassicConfig
+    {
+        static constexpr unsigned int tickrate           = 240;
+        static constexpr std::uint32_t invader_shot_period  = tickrate;
+        static constexpr std::uint32_t ship_spawn_period    = tickrate*15;
+        static constexpr std::uint32_t player_reload_period = tickrate/4;
+        static constexpr std::uint32_t wave_respawn_delay   = tickrate*3;
+        static constexpr int   trajectory_step_x         = 450*4;
+        static constexpr int   trajectory_step_y         = 20*4;
+    };
+}
+
+#endif //VARIANTS_H
@@ -0,0 +1,197 @@
+/**
+ * @file alloc.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include "alloc.hpp"
+
+#ifdef SI_ALLOCATION_TRACKING
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+#endif
+
+using namespace si;
+
+static constexpr std::size_t num_of_stages = static_cast<std::size_t>(AllocationStage::Count);
+
+static const std::array<const char*,num_of_stages> stage_names = 
+{
+    "other",
+    "input",
+    "game events",
+    "items control",
+    "collision",
+    "items update",
+    "particles",
+    "text",
+    "render queue",
+    "render submit",
+    "display",
+    "network",
+    "music"
+};
+
+#ifdef SI_ALLOCATION_TRACKING
+
+//counters are shared by all threads, stage is set per thread
+static std::array<std::atomic<std::uint64_t>,num_of_stages> allocation_counts{};
+static std::array<std::atomic<std::uint64_t>,num_of_stages> allocation_bytes{};
+static thread_local AllocationStage current_stage = AllocationStage::Other;
+
+static void countAllocation(std::size_t size) noexcept
+{
+    const auto stage = static_cast<std::size_t>(current_stage);
+    allocation_counts[stage].fetch_add(1,std::memory_order_relaxed);
+    allocation_bytes[stage].fetch_add(size,std::memory_order_relaxed);
+}
+
+static void* trackedAllocate(std::size_t size) noexcept
+{
+    countAllocation(size);
+    return std::malloc((size != 0) ? size : 1);
+}
+
+//over-aligned types (thread pool slices, event and sample rings) come here,
+//aligned memory is released by alignedFree only
+static void* trackedAllocate(std::size_t size, std::align_val_t alignment) noexcept
+{
+    countAllocation(size);
+    const auto align = static_cast<std::size_t>(alignment);
+    //size shall be multiple of alignment for aligned_alloc
+    const std::size_t padded = (size + align - 1)/align*align;
+#ifdef _MSC_VER
+    return _aligned_malloc((padded != 0) ? padded : align,align);
+#else
+    return std::aligned_alloc(align,(padded != 0) ? padded : align);
+#endif
+}
+
+static void alignedFree(void* pointer) noexcept
+{
+#ifdef _MSC_VER
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    void* pointer = trackedAllocate(size);
+    if(pointer == nullptr){throw std::bad_alloc();}
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* pointer = trackedAllocate(size);
+    if(pointer == nullptr){throw std::bad_alloc();}
+    return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {return trackedAllocate(size);}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {return trackedAllocate(size);}
+void operator delete(void* pointer) noexcept {std::free(pointer);}
+void operator delete[](void* pointer) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::size_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::size_t) noexcept {std::free(pointer);}
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {std::free(pointer);}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = trackedAllocate(size,alignment);
+    if(pointer == nullptr){throw std::bad_alloc();}
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = trackedAllocate(size,alignment);
+    if(pointer == nullptr){throw std::bad_alloc();}
+    return pointer;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {return trackedAllocate(size,alignment);}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {return trackedAllocate(size,alignment);}
+void operator delete(void* pointer, std::align_val_t) noexcept {alignedFree(pointer);}
+void operator delete[](void* pointer, std::align_val_t) noexcept {alignedFree(pointer);}
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {alignedFree(pointer);}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {alignedFree(pointer);}
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {alignedFree(pointer);}
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {alignedFree(pointer);}
+
+AllocationScope::AllocationScope(AllocationStage stage): previous(current_stage)
+{
+    current_stage = stage;
+}
+
+AllocationScope::~AllocationScope()
+{
+    current_stage = previous;
+}
+
+AllocationReport si::getAllocations()
+{
+    AllocationReport report;
+    for(std::size_t i = 0; i < num_of_stages; ++i)
+    {
+        report[i].count = allocation_counts[i].load(std::memory_order_relaxed);
+        report[i].bytes = allocation_bytes[i].load(std::memory_order_relaxed);
+    }
+    return report;
+}
+
+#else
+
+AllocationReport si::getAllocations()
+{
+    return AllocationReport();
+}
+
+#endif //SI_ALLOCATION_TRACKING
+
+AllocationReport si::getAllocationsSince(const AllocationReport& baseline)
+{
+    AllocationReport report = getAllocations();
+    for(std::size_t i = 0; i < num_of_stages; ++i)
+    {
+        report[i].count -= baseline[i].count;
+        report[i].bytes -= baseline[i].bytes;
+    }
+    return report;
+}
+
+AllocationCounters si::getTotal(const AllocationReport& report)
+{
+    AllocationCounters total;
+    for(const AllocationCounters& counters : report)
+    {
+        total.count += counters.count;
+        total.bytes += counters.bytes;
+    }
+    return total;
+}
+
+void si::printAllocations(const AllocationReport& report, std::ostream& stream)
+{
+    if(!allocation_tracking)
+    {
+        stream<<"allocations: tracking is not compiled in (SI_ALLOCATION_TRACKING)\n";
+        return;
+    }
+    const AllocationCounters total = getTotal(report);
+    stream<<"allocations: "<<total.count<<" ("<<total.bytes<<" bytes)\n";
+    for(std::size_t i = 0; i < num_of_stages; ++i)
+    {
+        if(report[i].count == 0){continue;}
+        stream<<"  "<<stage_names[i]<<" : "<<report[i].count<<" ("<<report[i].bytes<<" bytes)\n";
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * @file arena.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <cstdint>
+#include "arena.hpp"
+
+using namespace si;
+
+FrameArena::FrameArena(std::size_t capacity):
+                buffer(new unsigned char[capacity]),
+                capacity(capacity)
+{
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    used += size;
+    const auto base    = reinterpret_cast<std::uintptr_t>(buffer.get());
+    const auto aligned = (base + offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    const auto start   = static_cast<std::size_t>(aligned - base);
+    if(start + size <= capacity)
+    {
+        offset = start + size;
+        return buffer.get() + start;
+    }
+    //frame does not fit in buffer, it will be extended on reset
+    ++overflows;
+    used += alignment;
+    overflow_blocks.emplace_back(new unsigned char[size + alignment]);
+    const auto block = reinterpret_cast<std::uintptr_t>(overflow_blocks.back().get());
+    return reinterpret_cast<void*>((block + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+}
+
+void FrameArena::reset()
+{
+    if(!overflow_blocks.empty())
+    {
+        overflow_blocks.clear();
+        capacity = std::max(capacity*2,used);
+        buffer.reset(new unsigned char[capacity]);
+    }
+    offset = 0;
+    used   = 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file audio.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <stdexcept>
+#include <string>
+#include "audio.hpp"
+
+using namespace si;
+
+//sound files in order of SoundId
+static const std::array<std::string,static_cast<std::size_t>(SoundId::Count)> sound_files = 
+{
+    std::string("rc/sounds/shoot.wav"),
+    std::string("rc/sounds/invaderkilled.wav"),
+    std::string("rc/sounds/explosion.wav"),
+    std::string("rc/sounds/ufo_highpitch.wav")
+};
+
+void GameAudio::setup(AudioMode mode)
+{
+    this->mode = mode;
+    if((mode == AudioMode::Eager) && !loaded){load();}
+}
+
+void GameAudio::play(SoundId id)
+{
+    if(mode == AudioMode::Disabled){return;}
+    if(!loaded){load();}
+    sounds[static_cast<std::size_t>(id)]->play();
+}
+
+void GameAudio::stop(SoundId id)
+{
+    if(loaded){sounds[static_cast<std::size_t>(id)]->stop();}
+}
+
+void GameAudio::load()
+{
+    for(std::size_t i = 0; i < num_of_sounds; ++i)
+    {
+        buffers[i] = std::make_unique<sf::SoundBuffer>();
+        if(!buffers[i]->loadFromFile(sound_files[i]))
+        {
+            throw std::runtime_error(std::string("Could not load resource files!"));
+        }
+        sounds[i] = std::make_unique<sf::Sound>(*buffers[i]);
+    }
+    //shall be played during the time when ship is present on the canvas
+    sounds[static_cast<std::size_t>(SoundId::Ship)]->setLoop(true);
+    loaded = true;
+}
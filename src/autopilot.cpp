@@ -0,0 +1,291 @@
+/**
+ * @file autopilot.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#ifdef __linux__
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "alloc.hpp"
+#include "autopilot.hpp"
+#include "headless.hpp"
+#include "music.hpp"
+#include "pacer.hpp"
+
+using namespace si;
+
+/// @brief resident memory of the process in bytes, 0 if it is unknown
+static std::size_t residentMemory()
+{
+#ifdef __linux__
+    //plain system calls and stack buffer, file stream allocates and would fail allocation check
+    char statm[128];
+    const int file = ::open("/proc/self/statm",O_RDONLY);
+    if(file < 0){return 0;}
+    const auto length = ::read(file,statm,sizeof(statm) - 1);
+    ::close(file);
+    if(length <= 0){return 0;}
+    statm[length] = '\0';
+    //first field is total size, second one is resident size, both in pages
+    char* resident = nullptr;
+    std::strtoull(statm,&resident,10);
+    return static_cast<std::size_t>(std::strtoull(resident,nullptr,10)) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+Autopilot::Autopilot(float aggression): aggression(std::clamp(aggression,0.f,1.f))
+{
+}
+
+template<class GameType>
+void Autopilot::drive(GameType& game)
+{
+    if(game.status != GameStatus::Running)
+    {
+        //release keys and go through menu screens
+        setKey(game,sf::Keyboard::Key::Left,left_held,false);
+        setKey(game,sf::Keyboard::Key::Right,right_held,false);
+        if((game.status == GameStatus::NotStarted) || (game.status == GameStatus::GameOver))
+        {
+            tapKey(game,sf::Keyboard::Key::Space);
+        }
+        return;
+    }
+    //hit player is moved to start position and stops, held keys are pressed again
+    if(game.elements.player_lives != player_lives)
+    {
+        player_lives = game.elements.player_lives;
+        setKey(game,sf::Keyboard::Key::Left,left_held,false);
+        setKey(game,sf::Keyboard::Key::Right,right_held,false);
+    }
+
+    const sf::FloatRect player = game.player->getRectangle();
+    const float player_x = player.left + player.width/2.f;
+    int direction = findDodge(game);
+    bool aligned  = false;
+    if(direction == 0)
+    {
+        //target nearest invader column, invader ship is preferred by aggressive player
+        const Object* target = nullptr;
+        float distance = std::numeric_limits<float>::max();
+        if(game.invader_ship->isVisible() && (aggression >= 0.5f)){target = game.invader_ship.get();}
+        else
+        {
+            for(std::uint32_t index : game.getLiveInvaders())
+            {
+                const Invader& invader = game.enemies[index];
+                const sf::FloatRect rectangle = invader.getRectangle();
+                const float dx = std::fabs(rectangle.left + rectangle.width/2.f - player_x);
+                if(dx < distance)
+                {
+                    distance = dx;
+                    target   = &invader;
+                }
+            }
+        }
+        if(target != nullptr)
+        {
+            const sf::FloatRect rectangle = target->getRectangle();
+            const float dx        = rectangle.left + rectangle.width/2.f - player_x;
+            const float step      = game.player->getSpeed();
+            //aggressive player also fires when target is only near the line of fire
+            const float tolerance = rectangle.width/2.f * (1.f + 2.f*aggression);
+            aligned = std::fabs(dx) <= tolerance;
+            if(std::fabs(dx) > step){direction = (dx < 0.f) ? -1 : 1;}
+        }
+    }
+    setKey(game,sf::Keyboard::Key::Left,left_held,direction < 0);
+    setKey(game,sf::Keyboard::Key::Right,right_held,direction > 0);
+    //game ignores shot requests during reload, so pressing every tick fires at maximum rate
+    if(aligned || (aggression >= 1.f)){tapKey(game,sf::Keyboard::Key::Space);}
+}
+
+template<class GameType>
+void Autopilot::setKey(GameType& game, sf::Keyboard::Key key, bool& held, bool pressed)
+{
+    if(held == pressed){return;}
+    sf::Event event{};
+    event.type     = pressed ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+    event.key.code = key;
+    game.executeEvent(event);
+    held = pressed;
+}
+
+template<class GameType>
+void Autopilot::tapKey(GameType& game, sf::Keyboard::Key key)
+{
+    bool held = false;
+    setKey(game,key,held,true);
+    setKey(game,key,held,false);
+}
+
+template<class GameType>
+int Autopilot::findDodge(const GameType& game) const
+{
+    const sf::FloatRect player = game.player->getRectangle();
+    const float left       = player.left - dodge_margin;
+    const float right      = player.left + player.width + dodge_margin;
+    const float lookahead  = dodge_lookahead_ticks * (1.f - aggression);
+    float nearest          = std::numeric_limits<float>::max();
+    float threat_x         = 0.f;
+    for(std::uint32_t index : game.getLiveShells())
+    {
+        const Shell& shell = game.bullets[index];
+        if(shell.getShellType() != ShellType::Enemy){continue;}
+        const sf::FloatRect rectangle = shell.getRectangle();
+        if((rectangle.left + rectangle.width < left) || (rectangle.left > right)){continue;}
+        const float gap = player.top - (rectangle.top + rectangle.height);
+        if((gap < 0.f) || (gap > lookahead * shell.getVelocity().y) || (gap >= nearest)){continue;}
+        nearest  = gap;
+        threat_x = rectangle.left + rectangle.width/2.f;
+    }
+    if(nearest == std::numeric_limits<float>::max()){return 0;}
+    int direction = (threat_x > player.left + player.width/2.f) ? -1 : 1;
+    //turn back near the field borders
+    if((direction < 0) && (player.left - player.width < bottom_left_x)){direction = 1;}
+    if((direction > 0) && (player.left + 2.f*player.width > bottom_right_x)){direction = -1;}
+    return direction;
+}
+
+template void Autopilot::drive(Game& game);
+template void Autopilot::drive(StressGame& game);
+template void Autopilot::drive(BenchmarkGame& game);
+
+/// @brief soak loop specialized for game variant
+template<class GameType>
+static bool soak(const SoakOptions& options, std::ostream& stream)
+{
+    using clock = std::chrono::steady_clock;
+    using std::chrono::duration;
+    constexpr unsigned int framerate = GameType::tickrate;
+    GameType game;
+    setupHeadlessItems(game);
+    game.setSeed(options.seed);
+    if(options.parallel_collision){game.setParallelThreshold(options.parallel_threshold);}
+    Autopilot autopilot(options.aggression);
+    FramePacer pacer(framerate,true);
+
+    const std::uint64_t report_period = static_cast<std::uint64_t>(framerate)*soak_report_period_s;
+    std::uint64_t report_ticks = 0;
+    std::uint64_t games        = 0;
+    int best_score             = 0;
+    std::size_t peak_shells    = 0;
+    std::size_t peak_arena     = 0;
+    const auto start           = clock::now();
+    auto report_start          = start;
+    AllocationReport warm_allocations;
+    GameEventCounters event_counters;
+    std::unique_ptr<PerfCounters> perf;
+    if(options.perf_counters)
+    {
+        perf = std::make_unique<PerfCounters>();
+        game.setPerfCounters(perf.get());
+    }
+    std::unique_ptr<MusicStream> music;
+    std::unique_ptr<NullMusicOutput> music_output;
+    if(options.music)
+    {
+        music        = std::make_unique<MusicStream>();
+        music_output = std::make_unique<NullMusicOutput>(*music);
+    }
+
+    if((options.allocation_warmup != 0) && !allocation_tracking)
+    {
+        stream<<"soak: allocation check requires build with SI_ALLOCATION_TRACKING\n";
+        return false;
+    }
+
+    stream<<"soak: tickrate "<<framerate<<", invaders "<<game.enemies.size()<<", aggression "<<options.aggression<<", seed "<<options.seed
+          <<(options.realtime ? ", realtime\n" : ", unthrottled\n");
+    if(options.parallel_collision)
+    {
+        stream<<"soak: parallel collision detection from "<<options.parallel_threshold<<" live shells\n";
+    }
+    for(std::uint64_t tick = 0; (options.ticks == 0) || (tick < options.ticks); ++tick)
+    {
+        const bool was_running = game.status == GameStatus::Running;
+        autopilot.drive(game);
+        if(game.status == GameStatus::Running)
+        {
+            if(!was_running){++games;}
+            game.gameLoop();
+        }
+        game.events.drain([&](const GameEvent& event){event_counters.count(event);});
+        if(music)
+        {
+            music->setTrack(getMusicTrack(game.status));
+            music_output->consume(1.f/framerate);
+        }
+        best_score     = std::max(best_score,game.elements.score);
+        peak_shells    = std::max(peak_shells,game.bullets.size());
+        peak_arena     = std::max(peak_arena,game.arena.getUsed());
+        game.arena.reset();
+        //checked every tick before reporting, so a failure points at the tick that allocated
+        if((options.allocation_warmup != 0) && (tick + 1 > options.allocation_warmup))
+        {
+            //steady state shall reuse memory reserved during warm-up
+            const AllocationReport allocations = getAllocationsSince(warm_allocations);
+            if(getTotal(allocations).count != 0)
+            {
+                stream<<"soak: allocations after warm-up at tick "<<tick + 1<<"\n";
+                printAllocations(allocations,stream);
+                return false;
+            }
+        }
+        if((++report_ticks == report_period) || (tick + 1 == options.ticks))
+        {
+            const auto now = clock::now();
+            stream<<"soak: simulated s "<<(tick + 1)/framerate
+                  <<", ticks/s "<<static_cast<std::uint64_t>(report_ticks/duration<double>(now - report_start).count())
+                  <<", games "<<games
+                  <<", best score "<<best_score
+                  <<", peak shells "<<peak_shells
+                  <<", peak arena bytes "<<peak_arena
+                  <<", arena overflows "<<game.arena.getOverflows()
+                  <<", rss KiB "<<residentMemory()/1024
+                  <<"\n";
+            report_ticks = 0;
+            report_start = now;
+        }
+        //baseline is taken after reporting of the last warm-up tick
+        if((options.allocation_warmup != 0) && (tick + 1 == options.allocation_warmup))
+        {
+            warm_allocations = getAllocations();
+        }
+        if(options.realtime){pacer.waitForNextFrame();}
+    }
+    event_counters.print(stream);
+    if(perf){perf->print(stream);}
+    if(music)
+    {
+        //unthrottled run consumes samples faster than real time, so underruns are expected there
+        stream<<"soak: music samples "<<music_output->getConsumed()<<", underruns "<<music->getUnderruns()<<"\n";
+    }
+    if(options.allocation_warmup != 0){stream<<"soak: no allocations after warm-up\n";}
+    return true;
+}
+
+bool si::runSoak(const SoakOptions& options, std::ostream& stream)
+{
+    switch(options.variant)
+    {
+        case GameVariant::Stress:
+            return soak<StressGame>(options,stream);
+        case GameVariant::Benchmark:
+            return soak<BenchmarkGame>(options,stream);
+        case GameVariant::Classic:
+        default:
+            return soak<Game>(options,stream);
+    }
+}
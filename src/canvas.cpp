@@ -7,32 +7,19 @@
  *
  */
 
+#include <algorithm>
+#include <charconv>
+#include <iostream>
 #include "canvas.hpp"
+#include "alloc.hpp"
+#include "scene.hpp"
 
 //window title
 static const sf::String title = "Space Invaders";
 //game version
 static const sf::String version = "0.01";
-//object rectangles for the menu frames
-static const std::array<sf::IntRect,num_of_frames> frame_rectangles = 
-{
-    sf::IntRect(0,0,si::default_x_size,si::frame_width),
-    sf::IntRect(0,0,si::frame_width,si::default_y_size),
-    sf::IntRect(0,0,si::default_x_size,si::frame_width),
-    sf::IntRect(0,0,si::frame_width,si::default_y_size),
-    sf::IntRect(0,0,si::default_x_size,si::frame_width)
-};
-//object positions for the menu frames
-static const std::array<sf::Vector2f,num_of_frames> frame_positions = 
-{
-    sf::Vector2f(si::default_start_x,si::default_start_y),
-    sf::Vector2f(si::default_x_size - static_cast<float>(si::frame_width),si::default_start_y),
-    sf::Vector2f(si::default_start_x,static_cast<float>(si::frame_length)),
-    sf::Vector2f(si::default_start_x,si::default_start_y),
-    sf::Vector2f(si::default_start_x,si::default_y_size - static_cast<float>(si::frame_width))
-};
 //welcome window text array
-static const std::array<std::string,5> welcome_text = 
+static const std::array<std::string,num_of_welcome_lines> welcome_text = 
 {
     std::string(title + " version : " + version),
     std::string("Controls:"),
@@ -41,18 +28,37 @@ static const std::array<std::string,5> welcome_text =
     std::string("Press Space key to start...")
 };
 
-Canvas::Canvas(const unsigned int framerate):
+Canvas::Canvas(const unsigned int framerate, const CanvasOptions& options, si::Client* client):
+                options(options),
+                startup(options.start_time),
                 window(sf::VideoMode(canvas_width, canvas_height), title),
-                game(si::Game(framerate))
+                pacer(framerate,options.power_saving),
+                governor(framerate,options.governor_log ? &std::cout : nullptr),
+                client(client),
+                render_backend(window)
 {
     sf::View view(sf::FloatRect(si::default_start_x, si::default_start_y, si::default_x_size, si::default_y_size));
     window.setView(view);
     window.setActive(true);
-    window.setFramerateLimit(framerate);
+    startup.mark("window and game creation");
+    if(options.perf_counters)
+    {
+        perf = std::make_unique<si::PerfCounters>();
+        game.setPerfCounters(perf.get());
+    }
+    if(!options.capture.directory.empty()){capture = std::make_unique<si::FrameCapture>(options.capture,window.getSize());}
     loadResources();
     setupTextures();
+    startup.mark("textures setup");
     setupSounds();
+    startup.mark(options.lazy_audio ? "audio (deferred)" : "audio device and sounds");
     setupMenu();
+    startup.mark("menu setup");
+    if(options.glyph_prewarm)
+    {
+        prewarmGlyphs();
+        startup.mark("glyph prewarm");
+    }
 }
 
 void Canvas::runEventLoop()
@@ -60,8 +66,28 @@ void Canvas::runEventLoop()
     sf::Event event;
     while (window.isOpen())
     {
-        while(window.pollEvent(event)){game.executeEvent(event);}
+        //remote game state is driven by server snapshots
+        if(client)
+        {
+            si::AllocationScope scope(si::AllocationStage::Network);
+            client->update(game);
+        }
+        {
+            si::AllocationScope scope(si::AllocationStage::Input);
+            while(window.pollEvent(event))
+            {
+                if((client == nullptr) || (event.type == sf::Event::Closed)){game.executeEvent(event);}
+                else{client->handleEvent(event);}
+            }
+        }
+        //music crossfades on screen change
+        if(music){music->setTrack(si::getMusicTrack(game.status));}
+        const auto frame_start = FramePacer::clock::now();
+        //first frame of every screen and frames with new score text may rasterize glyphs
+        bool text_appears = !seen_screens[static_cast<std::size_t>(game.status)];
+        seen_screens[static_cast<std::size_t>(game.status)] = true;
         window.clear(sf::Color::Black);
+        render_queue.clear();
         switch(game.status)
         {
             case si::GameStatus::NotStarted:
@@ -69,172 +95,217 @@ void Canvas::runEventLoop()
                 break;
             
             case si::GameStatus::Running:
-                game.gameLoop();
-                menu_sprites.score.setString("SCORE: " + std::to_string(game.elements.score));
-                updateCanvas();
+                if(client == nullptr){game.gameLoop();}
+                {
+                    si::AllocationScope scope(si::AllocationStage::Text);
+                    text_appears |= processGameEvents();
+                }
+                {
+                    si::AllocationScope scope(si::AllocationStage::RenderQueue);
+                    si::PerfScope perf_scope(perf.get(),si::PerfStage::CanvasUpdate);
+                    updateCanvas();
+                }
                 break;
-            
+
             case si::GameStatus::GameOver:
+            {
+                si::AllocationScope scope(si::AllocationStage::Text);
+                text_appears |= processGameEvents();
                 drawGameOverScreen();
                 break;
+            }
             case si::GameStatus::Closed:    
             default:
                 window.close();
                 break;
         }
-        window.display();
+        {
+            //items are drawn grouped by layer and texture
+            si::AllocationScope scope(si::AllocationStage::RenderSubmit);
+            render_queue.sort();
+            render_backend.submit(render_queue);
+        }
+        //frame is read back before display swaps buffers
+        if(capture){capture->captureFrame(window.getSize());}
+        {
+            si::AllocationScope scope(si::AllocationStage::Display);
+            window.display();
+        }
+        if(!first_frame_presented)
+        {
+            first_frame_presented = true;
+            startup.mark("first frame");
+            startup.print(std::cout);
+            //lazy mode starts music after the window is shown
+            if(options.music && !music){startMusic();}
+        }
+        if(text_appears){worst_text_frame = std::max(worst_text_frame,FramePacer::clock::now() - frame_start);}
+        if(options.governor)
+        {
+            governor.recordFrame(FramePacer::clock::now() - frame_start);
+            game.particles.setDensity(governor.getParticleDensity());
+        }
+        //all transient data of the frame is released here
+        game.arena.reset();
+        pacer.waitForNextFrame();
     }
+    pacer.printStatistics(std::cout);
+    if(options.governor){governor.printStatistics(std::cout);}
+    si::printAllocations(si::getAllocations(),std::cout);
+    event_counters.print(std::cout);
+    if(perf){perf->print(std::cout);}
+    if(music){std::cout<<"music underruns: "<<music->getUnderruns()<<"\n";}
+    if(capture)
+    {
+        capture->finish();
+        capture->printStatistics(std::cout);
+    }
+    std::cout<<"worst frame with new text: "<<std::chrono::duration_cast<std::chrono::microseconds>(worst_text_frame).count()
+             <<" us (glyph prewarm "<<(options.glyph_prewarm ? "on" : "off")<<")\n";
 }
 
 void Canvas::updateCanvas()
 {
-    //update score indicator
-    window.draw(menu_sprites.score);
-    //update lives indicator
-    drawPlayerLives();
-    //update menu frames
-    for(Object & frame : menu_sprites.frames){window.draw(frame.getSprite());}
-    //update enemies 
-    for (Invader& enemy : game.enemies)
-    {
-        if(enemy.isVisible()){window.draw(enemy.getSprite());}
-    }    
-    //update bullets
-    for (Shell& shell : game.bullets)
+    //update score, lives indicator and menu frames
+    si::recordHud(render_queue,menu_sprites,shown_lives);
+    //update game items
+    si::recordGameItems(render_queue,game);
+}
+
+bool Canvas::processGameEvents()
+{
+    game.events.drain([&](const si::GameEvent& event)
     {
-        if(shell.isVisible()){window.draw(shell.getSprite());}
-    }
-    //update obstacles
-    for (Obstacle& obstacle : game.obstacles)
+        event_counters.count(event);
+        switch(event.type)
+        {
+            case si::GameEventType::Shot:
+                if(event.value == static_cast<std::int32_t>(ShellType::Player)){audio.play(si::SoundId::Shoot);}
+                break;
+            case si::GameEventType::InvaderKilled:
+                audio.play(si::SoundId::InvaderKilled);
+                break;
+            case si::GameEventType::LifeLost:
+                audio.play(si::SoundId::PlayerKilled);
+                break;
+            case si::GameEventType::ShipSpawned:
+                audio.play(si::SoundId::Ship);
+                break;
+            case si::GameEventType::ShipLeft:
+            case si::GameEventType::ShipKilled:
+            case si::GameEventType::GameOver:
+                audio.stop(si::SoundId::Ship);
+                break;
+            case si::GameEventType::ScoreChanged:
+                pending_score = event.value;
+                break;
+            case si::GameEventType::LivesChanged:
+                shown_lives = event.value;
+                break;
+            default:
+                break;
+        }
+    });
+    //governor may throttle HUD text during the game, final score is shown at once
+    bool text_rebuilt  = false;
+    const bool running = game.status == si::GameStatus::Running;
+    if((++frames_since_score >= governor.getHudRefreshPeriod()) || !running)
     {
-        if(obstacle.isVisible()){window.draw(obstacle.getSprite());}
+        text_rebuilt = updateScore(pending_score);
+        if(text_rebuilt){frames_since_score = 0;}
     }
-    //update enemy ship
-    if(game.invader_ship->isVisible()){window.draw(game.invader_ship->getSprite());}
-    //update player ship
-    window.draw(game.player->getSprite());
+    return text_rebuilt;
 }
 
-void Canvas::setupMenu()
+bool Canvas::updateScore(int score)
+{
+    if(shown_score == score){return false;}
+    shown_score = score;
+    //number is formatted in frame arena, only sf::Text update touches the heap
+    char digits[16];
+    const auto result = std::to_chars(std::begin(digits),std::end(digits),shown_score);
+    si::ScratchString text("SCORE: ",game.arena);
+    text.append(digits,result.ptr);
+    menu_sprites.score.setString(text.c_str());
+    text.assign("Your score : ");
+    text.append(digits,result.ptr);
+    menu_sprites.game_over[1].setString(text.c_str());
+    return true;
+}
+
+void Canvas::prewarmGlyphs()
 {
-    //setup game score item
-    menu_sprites.score.setFont(resources.game_font);
-    menu_sprites.score.setCharacterSize(font_size);
-    menu_sprites.score.setPosition(sf::Vector2f(static_cast<float>(si::frame_length),static_cast<float>(si::frame_width)));
-    //player lives indicator
-    menu_sprites.live.setTexture(resources.player);
-    //setup canvas frames
-    for (Object& frame: menu_sprites.frames)
+    //all characters that can appear in welcome screen, HUD and game over screen
+    std::string characters = "SCORE: Your score : 0123456789";
+    for(const std::string& line : welcome_text){characters += line;}
+    for(const sf::Text& line : menu_sprites.game_over){characters += line.getString().toAnsiString();}
+    std::sort(characters.begin(),characters.end());
+    characters.erase(std::unique(characters.begin(),characters.end()),characters.end());
+    for(const char character : characters)
     {
-        auto i = &frame - &menu_sprites.frames[0];
-        frame.setSpriteRectangle(frame_rectangles[i]);
-        frame.setTexture(resources.frame);
-        frame.setSpriteColor(sf::Color::White);
-        frame.setPosition(frame_positions[i]);
+        resources.game_font.getGlyph(static_cast<sf::Uint32>(static_cast<unsigned char>(character)),font_size,false);
     }
 }
 
-void Canvas::drawPlayerLives()
+void Canvas::setupMenu()
 {
-    //small border to prevent sprites from sticking together
-    constexpr float border = 10.f;
-    sf::IntRect texture_size =  menu_sprites.live.getTextureRect();
-    //initial offset, lives will be drawn from right to left
-    float offset = si::default_x_size - si::frame_width - static_cast<float>(texture_size.width) - border;
-    for(auto i = 0; i < game.elements.player_lives; i++)
+    //score, player lives indicator and canvas frames
+    si::setupHud(menu_sprites,resources.game_font,font_size,resources.player,resources.frame);
+    //welcome and game over screens are built once, only score line is updated
+    auto setup_lines = [this](auto& lines)
     {
-        menu_sprites.live.setPosition(sf::Vector2f(offset,static_cast<float>(si::frame_width)));
-        window.draw(menu_sprites.live);
-        offset -= static_cast<float>(texture_size.width) + border;
-    }
+        sf::Vector2f position(si::default_border_size,si::default_border_size);
+        for(sf::Text& line : lines)
+        {
+            line.setFont(resources.game_font);
+            line.setCharacterSize(font_size);
+            line.setPosition(position);
+            position.y += si::default_border_size;
+        }
+    };
+    setup_lines(menu_sprites.welcome);
+    setup_lines(menu_sprites.game_over);
+    for(std::size_t i = 0; i < welcome_text.size(); ++i){menu_sprites.welcome[i].setString(welcome_text[i]);}
+    menu_sprites.game_over[0].setString("GAME OVER");
+    menu_sprites.game_over[2].setString("Press Space key to restart the game");
+    //score text is rebuilt on score events only
+    updateScore(game.elements.score);
 }
 
 void Canvas::drawWelcomeWindow()
 {
-    sf::Text text_var;
-    sf::Vector2f position(si::default_border_size,si::default_border_size);
-    text_var.setFont(resources.game_font);
-    text_var.setCharacterSize(font_size);
-
-    for(const std::string& text : welcome_text)
-    {
-        text_var.setString(text);
-        text_var.setPosition(position);
-        window.draw(text_var);
-        position.y += si::default_border_size;
-    }
+    for(const sf::Text& text : menu_sprites.welcome){render_queue.add(si::RenderLayer::Menu,text);}
 }
 
 void Canvas::drawGameOverScreen()
 {
-    sf::Text text;
-    sf::Vector2f position(si::default_border_size,si::default_border_size);
-    text.setFont(resources.game_font);
-    text.setCharacterSize(font_size);
-
-    text.setString("GAME OVER");
-    text.setPosition(position);
-    window.draw(text);
-    position.y += si::default_border_size;
-
-    text.setString("Your score : " + std::to_string(game.elements.score));
-    text.setPosition(position);
-    window.draw(text);
-    position.y += si::default_border_size;
-
-    text.setString("Press Space key to restart the game");
-    text.setPosition(position);
-    window.draw(text);
+    for(const sf::Text& text : menu_sprites.game_over){render_queue.add(si::RenderLayer::Menu,text);}
 }
 
 void Canvas::loadResources()
 {
-    //textures
-    if(!resources.enemy_type_1.loadFromFile("rc/textures/green.png"))
+    //textures, collision masks are built from the same images
+    auto load_texture = [](sf::Texture& texture, si::CollisionMask& mask, const std::string& path)
     {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    if(!resources.enemy_type_2.loadFromFile("rc/textures/red.png"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    if(!resources.enemy_type_3.loadFromFile("rc/textures/yellow.png"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    if(!resources.player.loadFromFile("rc/textures/player.png"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    if(!resources.enemy_ship.loadFromFile("rc/textures/extra.png"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
+        sf::Image image;
+        if(!image.loadFromFile(path) || !texture.loadFromImage(image))
+        {
+            throw std::runtime_error(std::string("Could not load resource files!"));
+        }
+        mask = si::CollisionMask(image);
+    };
+    load_texture(resources.enemy_type_1,resources.enemy_type_1_mask,"rc/textures/green.png");
+    load_texture(resources.enemy_type_2,resources.enemy_type_2_mask,"rc/textures/red.png");
+    load_texture(resources.enemy_type_3,resources.enemy_type_3_mask,"rc/textures/yellow.png");
+    load_texture(resources.player,resources.player_mask,"rc/textures/player.png");
+    load_texture(resources.enemy_ship,resources.enemy_ship_mask,"rc/textures/extra.png");
+    startup.mark("texture decoding");
     //font
     if(!resources.game_font.loadFromFile("rc/fonts/SpaceMission.ttf"))
     {
         throw std::runtime_error(std::string("Could not load resource files!"));
     }
-    //shoot sound
-    if(!resources.shoot_sound_buffer.loadFromFile("rc/sounds/shoot.wav"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    //invader killed sound
-    if(!resources.invader_killed_sound_buffer.loadFromFile("rc/sounds/invaderkilled.wav"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    //player killed sound
-    if(!resources.player_killed_sound_buffer.loadFromFile("rc/sounds/explosion.wav"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
-    //invader ship sound
-    if(!resources.ship_sound_buffer.loadFromFile("rc/sounds/ufo_highpitch.wav"))
-    {
-        throw std::runtime_error(std::string("Could not load resource files!"));
-    }
+    startup.mark("font loading");
     resources.player.setSmooth(true);
     resources.enemy_ship.setSmooth(true);
     resources.enemy_type_1.setSmooth(true);
@@ -244,12 +315,17 @@ void Canvas::loadResources()
 
 void Canvas::setupSounds()
 {
-    //game.sounds.shoot_sound.setBuffer(resources.shoot_sound_buffer);
-    //game.sounds.invader_killed_sound.setBuffer(resources.invader_killed_sound_buffer);
-    //game.sounds.player_killed_sound.setBuffer(resources.player_killed_sound_buffer);
-    //game.sounds.ship_sound.setBuffer(resources.ship_sound_buffer);
-    //shall be played during the time when ship is present on the canvas
-    //game.sounds.ship_sound.setLoop(true);
+    //lazy mode opens audio device on first played sound, so window shows sooner
+    audio.setup(options.lazy_audio ? si::AudioMode::Lazy : si::AudioMode::Eager);
+    if(options.music && !options.lazy_audio){startMusic();}
+}
+
+void Canvas::startMusic()
+{
+    music        = std::make_unique<si::MusicStream>();
+    music_output = std::make_unique<si::MusicOutput>(*music);
+    music->setTrack(si::getMusicTrack(game.status));
+    music_output->play();
 }
 
 void Canvas::setupTextures()
@@ -261,22 +337,27 @@ void Canvas::setupTextures()
             case 1:
             case 4:
                 invader.setTexture(resources.enemy_type_2);
+                invader.setCollisionMask(&resources.enemy_type_2_mask);
                 break;
             case 2:
             case 5:
                 invader.setTexture(resources.enemy_type_3);
+                invader.setCollisionMask(&resources.enemy_type_3_mask);
                 break;
             case 0:
             case 3:
             default:
                 invader.setTexture(resources.enemy_type_1);
+                invader.setCollisionMask(&resources.enemy_type_1_mask);
                 break;
         }
     };
 
     for(Obstacle& obstacle : game.obstacles){obstacle.setTexture(resources.obstacle);}
     game.player->setTexture(resources.player);
+    game.player->setCollisionMask(&resources.player_mask);
     game.invader_ship->setTexture(resources.enemy_ship);
+    game.invader_ship->setCollisionMask(&resources.enemy_ship_mask);
     //set texture and color for first shell in array
     game.bullets[0].setTexture(resources.shell);
     game.bullets[0].setSpriteColor(sf::Color(40, 236, 250));
@@ -286,6 +367,6 @@ void Canvas::setupTextures()
     for(auto i = 0; i <num_of_invaders; ++i)
     {
         set_texture(game.enemies[i],row_counter);
-        if(((i+1) % si::invaders_in_row) == 0){row_counter++;}
+        if(((i+1) % si::Game::config_type::invaders_in_row) == 0){row_counter++;}
     }
 }
@@ -0,0 +1,368 @@
+/**
+ * @file capture.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <SFML/Graphics.hpp>
+#include <SFML/OpenGL.hpp>
+#include "capture.hpp"
+
+using namespace si;
+
+//pixel buffer objects are not in GL 1.1 headers, functions are loaded at runtime
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+#ifdef _WIN32
+#define CAPTURE_GL_API __stdcall
+#else
+#define CAPTURE_GL_API
+#endif
+
+struct PixelBufferApi
+{
+    void (CAPTURE_GL_API *genBuffers)(GLsizei, GLuint*) = nullptr;
+    void (CAPTURE_GL_API *deleteBuffers)(GLsizei, const GLuint*) = nullptr;
+    void (CAPTURE_GL_API *bindBuffer)(GLenum, GLuint) = nullptr;
+    void (CAPTURE_GL_API *bufferData)(GLenum, std::ptrdiff_t, const void*, GLenum) = nullptr;
+    void* (CAPTURE_GL_API *mapBuffer)(GLenum, GLenum) = nullptr;
+    GLboolean (CAPTURE_GL_API *unmapBuffer)(GLenum) = nullptr;
+};
+
+static PixelBufferApi pixel_buffer_api;
+
+template<class Function>
+static bool loadFunction(Function& function, const char* name)
+{
+    function = reinterpret_cast<Function>(sf::Context::getFunction(name));
+    return function != nullptr;
+}
+
+//pixel buffer objects are core since GL 2.1, function pointers alone do not prove support
+static bool pixelBuffersSupported()
+{
+    if(sf::Context::isExtensionAvailable("GL_ARB_pixel_buffer_object")){return true;}
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if(version == nullptr){return false;}
+    char* end = nullptr;
+    const long major = std::strtol(version,&end,10);
+    const long minor = (*end == '.') ? std::strtol(end + 1,nullptr,10) : 0;
+    return (major > 2) || ((major == 2) && (minor >= 1));
+}
+
+static bool loadPixelBufferApi()
+{
+    if(!pixelBuffersSupported()){return false;}
+    bool loaded = loadFunction(pixel_buffer_api.genBuffers,"glGenBuffers");
+    loaded = loadFunction(pixel_buffer_api.deleteBuffers,"glDeleteBuffers") && loaded;
+    loaded = loadFunction(pixel_buffer_api.bindBuffer,"glBindBuffer") && loaded;
+    loaded = loadFunction(pixel_buffer_api.bufferData,"glBufferData") && loaded;
+    loaded = loadFunction(pixel_buffer_api.mapBuffer,"glMapBuffer") && loaded;
+    loaded = loadFunction(pixel_buffer_api.unmapBuffer,"glUnmapBuffer") && loaded;
+    return loaded;
+}
+
+FrameCapture::FrameCapture(const CaptureOptions& options, sf::Vector2u size):
+                options(options),
+                size(size),
+                slots(std::make_unique<Slot[]>(std::max<std::size_t>(options.slots,1))),
+                queue(std::max<std::size_t>(options.slots,1))
+{
+    this->options.slots = queue.size();
+    std::error_code error;
+    std::filesystem::create_directories(options.directory,error);
+    if(error)
+    {
+        throw std::runtime_error(std::string("Could not create capture directory!"));
+    }
+    for(std::size_t i = 0; i < this->options.slots; ++i)
+    {
+        slots[i].pixels.resize(static_cast<std::size_t>(size.x)*size.y*4);
+    }
+    auto num_of_workers = options.workers;
+    if(num_of_workers == 0){num_of_workers = std::max(1u,std::thread::hardware_concurrency()/2);}
+    for(std::size_t i = 0; i < num_of_workers; ++i){workers.emplace_back(&FrameCapture::work,this);}
+}
+
+FrameCapture::~FrameCapture()
+{
+    finish();
+}
+
+void FrameCapture::captureFrame(sf::Vector2u size)
+{
+    const auto start = clock::now();
+    ++frames;
+    if(size != this->size)
+    {
+        ++dropped;
+        return;
+    }
+    if(!readback_checked){setupReadback();}
+    glPixelStorei(GL_PACK_ALIGNMENT,1);
+    glReadBuffer(GL_BACK);
+    if(async){readAsync();}
+    else if(Slot* slot = acquireSlot(false))
+    {
+        //synchronous read back waits until GL finishes the frame
+        glReadPixels(0,0,static_cast<GLsizei>(size.x),static_cast<GLsizei>(size.y),GL_RGBA,GL_UNSIGNED_BYTE,slot->pixels.data());
+        queueSlot(frames);
+    }
+    capture_time += clock::now() - start;
+}
+
+void FrameCapture::setupReadback()
+{
+    readback_checked = true;
+    if(!options.async_readback || !loadPixelBufferApi()){return;}
+    const auto frame_bytes = static_cast<std::ptrdiff_t>(size.x)*size.y*4;
+    for(Readback& readback : readbacks)
+    {
+        GLuint buffer = 0;
+        pixel_buffer_api.genBuffers(1,&buffer);
+        pixel_buffer_api.bindBuffer(GL_PIXEL_PACK_BUFFER,buffer);
+        pixel_buffer_api.bufferData(GL_PIXEL_PACK_BUFFER,frame_bytes,nullptr,GL_STREAM_READ);
+        readback.buffer = buffer;
+    }
+    pixel_buffer_api.bindBuffer(GL_PIXEL_PACK_BUFFER,0);
+    async = true;
+}
+
+FrameCapture::Slot* FrameCapture::acquireSlot(bool wait)
+{
+    Slot& slot = slots[next_slot];
+    while(slot.busy.load(std::memory_order_acquire))
+    {
+        //capture never waits during the game, frame is dropped if workers are behind
+        if(!wait)
+        {
+            ++dropped;
+            return nullptr;
+        }
+        std::this_thread::yield();
+    }
+    return &slot;
+}
+
+void FrameCapture::queueSlot(std::uint64_t frame)
+{
+    Slot& slot = slots[next_slot];
+    slot.frame = frame;
+    slot.busy.store(true,std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue[(queue_head + queue_size) % queue.size()] = next_slot;
+        ++queue_size;
+    }
+    wake.notify_one();
+    next_slot = (next_slot + 1) % options.slots;
+}
+
+void FrameCapture::readAsync()
+{
+    Readback& readback = readbacks[next_readback];
+    pixel_buffer_api.bindBuffer(GL_PIXEL_PACK_BUFFER,readback.buffer);
+    //copy started capture_readback_buffers frames ago is finished by now in most cases
+    if(readback.frame != 0){collect(readback,false);}
+    //with bound pack buffer the pointer is an offset, call returns without waiting for the copy
+    glReadPixels(0,0,static_cast<GLsizei>(size.x),static_cast<GLsizei>(size.y),GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+    pixel_buffer_api.bindBuffer(GL_PIXEL_PACK_BUFFER,0);
+    readback.frame = frames;
+    next_readback  = (next_readback + 1) % readbacks.size();
+}
+
+void FrameCapture::collect(Readback& readback, bool wait)
+{
+    const std::uint64_t frame = readback.frame;
+    readback.frame = 0;
+    Slot* slot = acquireSlot(wait);
+    if(slot == nullptr){return;}
+    const void* pixels = pixel_buffer_api.mapBuffer(GL_PIXEL_PACK_BUFFER,GL_READ_ONLY);
+    if(pixels == nullptr)
+    {
+        failed.fetch_add(1,std::memory_order_relaxed);
+        return;
+    }
+    std::memcpy(slot->pixels.data(),pixels,slot->pixels.size());
+    pixel_buffer_api.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    queueSlot(frame);
+}
+
+void FrameCapture::finish()
+{
+    if(async && (readbacks[0].buffer != 0))
+    {
+        //buffers are shared by all SFML contexts, own context works after target is closed
+        sf::Context context;
+        for(std::size_t i = 0; i < readbacks.size(); ++i)
+        {
+            Readback& readback = readbacks[(next_readback + i) % readbacks.size()];
+            pixel_buffer_api.bindBuffer(GL_PIXEL_PACK_BUFFER,readback.buffer);
+            if(readback.frame != 0){collect(readback,true);}
+            pixel_buffer_api.deleteBuffers(1,&readback.buffer);
+            readback.buffer = 0;
+        }
+        pixel_buffer_api.bindBuffer(GL_PIXEL_PACK_BUFFER,0);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(std::thread& worker : workers)
+    {
+        if(worker.joinable()){worker.join();}
+    }
+    workers.clear();
+}
+
+void FrameCapture::work()
+{
+    std::vector<std::uint8_t> buffer;
+    while(true)
+    {
+        std::size_t index = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock,[this]{return stopping || (queue_size > 0);});
+            //queued frames are written before stop
+            if(queue_size == 0){return;}
+            index = queue[queue_head];
+            queue_head = (queue_head + 1) % queue.size();
+            --queue_size;
+        }
+        if(write(slots[index],buffer)){written.fetch_add(1,std::memory_order_relaxed);}
+        else{failed.fetch_add(1,std::memory_order_relaxed);}
+        slots[index].busy.store(false,std::memory_order_release);
+    }
+}
+
+bool FrameCapture::write(const Slot& slot, std::vector<std::uint8_t>& buffer) const
+{
+    char name[32];
+    const bool qoi = options.format == CaptureFormat::Qoi;
+    std::snprintf(name,sizeof(name),"frame_%06llu.%s",static_cast<unsigned long long>(slot.frame),qoi ? "qoi" : "png");
+    const auto path = std::filesystem::path(options.directory)/name;
+    if(qoi)
+    {
+        encodeQoi(slot.pixels.data(),size,buffer);
+        std::ofstream file(path,std::ios::binary);
+        file.write(reinterpret_cast<const char*>(buffer.data()),static_cast<std::streamsize>(buffer.size()));
+        return static_cast<bool>(file);
+    }
+    sf::Image image;
+    image.create(size.x,size.y,slot.pixels.data());
+    image.flipVertically();
+    return image.saveToFile(path.string());
+}
+
+void si::encodeQoi(const std::uint8_t* pixels, sf::Vector2u size, std::vector<std::uint8_t>& output)
+{
+    // QOI format: 14 bytes header, chunks of operations, 8 bytes end marker
+    constexpr std::uint8_t op_index = 0x00;
+    constexpr std::uint8_t op_diff  = 0x40;
+    constexpr std::uint8_t op_luma  = 0x80;
+    constexpr std::uint8_t op_run   = 0xc0;
+    constexpr std::uint8_t op_rgb   = 0xfe;
+    constexpr std::uint8_t op_rgba  = 0xff;
+    constexpr int max_run           = 62;
+
+    auto put32 = [&output](std::uint32_t value)
+    {
+        for(int shift = 24; shift >= 0; shift -= 8){output.push_back(static_cast<std::uint8_t>(value >> shift));}
+    };
+    output.clear();
+    output.reserve(static_cast<std::size_t>(size.x)*size.y*5 + 22);
+    output.insert(output.end(),{'q','o','i','f'});
+    put32(size.x);
+    put32(size.y);
+    output.push_back(4);
+    output.push_back(0);
+
+    std::array<std::array<std::uint8_t,4>,64> index{};
+    std::array<std::uint8_t,4> previous = {0,0,0,255};
+    int run = 0;
+    const std::size_t row_size = static_cast<std::size_t>(size.x)*4;
+    for(std::size_t y = size.y; y > 0; --y)
+    {
+        //GL rows are bottom-up, image rows are top-down
+        const std::uint8_t* row = pixels + (y - 1)*row_size;
+        const bool last_row = y == 1;
+        for(std::size_t x = 0; x < size.x; ++x)
+        {
+            const std::array<std::uint8_t,4> pixel = {row[x*4],row[x*4 + 1],row[x*4 + 2],row[x*4 + 3]};
+            const bool last_pixel = last_row && (x + 1 == size.x);
+            if(pixel == previous)
+            {
+                if((++run == max_run) || last_pixel)
+                {
+                    output.push_back(static_cast<std::uint8_t>(op_run | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+            if(run > 0)
+            {
+                output.push_back(static_cast<std::uint8_t>(op_run | (run - 1)));
+                run = 0;
+            }
+            const auto hash = (pixel[0]*3 + pixel[1]*5 + pixel[2]*7 + pixel[3]*11) % 64;
+            if(index[hash] == pixel){output.push_back(static_cast<std::uint8_t>(op_index | hash));}
+            else
+            {
+                index[hash] = pixel;
+                if(pixel[3] == previous[3])
+                {
+                    const auto dr    = static_cast<std::int8_t>(pixel[0] - previous[0]);
+                    const auto dg    = static_cast<std::int8_t>(pixel[1] - previous[1]);
+                    const auto db    = static_cast<std::int8_t>(pixel[2] - previous[2]);
+                    const int dr_dg  = dr - dg;
+                    const int db_dg  = db - dg;
+                    if((dr > -3) && (dr < 2) && (dg > -3) && (dg < 2) && (db > -3) && (db < 2))
+                    {
+                        output.push_back(static_cast<std::uint8_t>(op_diff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+                    }
+                    else if((dr_dg > -9) && (dr_dg < 8) && (dg > -33) && (dg < 32) && (db_dg > -9) && (db_dg < 8))
+                    {
+                        output.push_back(static_cast<std::uint8_t>(op_luma | (dg + 32)));
+                        output.push_back(static_cast<std::uint8_t>(((dr_dg + 8) << 4) | (db_dg + 8)));
+                    }
+                    else{output.insert(output.end(),{op_rgb,pixel[0],pixel[1],pixel[2]});}
+                }
+                else{output.insert(output.end(),{op_rgba,pixel[0],pixel[1],pixel[2],pixel[3]});}
+            }
+            previous = pixel;
+        }
+    }
+    output.insert(output.end(),{0,0,0,0,0,0,0,1});
+}
+
+void FrameCapture::printStatistics(std::ostream& stream) const
+{
+    using std::chrono::duration;
+    stream<<"capture: frames "<<frames
+          <<", written "<<written.load(std::memory_order_relaxed)
+          <<", dropped "<<dropped
+          <<", failed "<<failed.load(std::memory_order_relaxed)
+          <<", readback "<<(async ? "pixel buffers" : "synchronous")
+          <<", main thread us/frame "<<((frames != 0) ? static_cast<unsigned long long>(duration<double,std::micro>(capture_time).count()/frames) : 0)
+          <<"\n";
+}
@@ -0,0 +1,34 @@
+/**
+ * @file events.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include "events.hpp"
+
+using namespace si;
+
+static const std::array<const char*,static_cast<std::size_t>(GameEventType::Count)> event_names = 
+{
+    "shot",
+    "invader killed",
+    "life lost",
+    "ship spawned",
+    "ship left",
+    "ship killed",
+    "score changed",
+    "lives changed",
+    "game over"
+};
+
+void GameEventCounters::print(std::ostream& stream) const
+{
+    stream<<"game events:";
+    for(std::size_t i = 0; i < counters.size(); ++i)
+    {
+        stream<<(i == 0 ? " " : ", ")<<event_names[i]<<" "<<counters[i];
+    }
+    stream<<"\n";
+}
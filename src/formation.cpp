@@ -0,0 +1,129 @@
+/**
+ * @file formation.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include "formation.hpp"
+#include "variants.hpp"
+
+using namespace si;
+
+/// @brief union of two rectangles, empty rectangle is ignored
+static sf::FloatRect unite(const sf::FloatRect& a, const sf::FloatRect& b)
+{
+    if((a.width <= 0.f) || (a.height <= 0.f)){return b;}
+    if((b.width <= 0.f) || (b.height <= 0.f)){return a;}
+    const float left   = std::min(a.left,b.left);
+    const float top    = std::min(a.top,b.top);
+    const float right  = std::max(a.left + a.width,b.left + b.width);
+    const float bottom = std::max(a.top + a.height,b.top + b.height);
+    return sf::FloatRect(left,top,right - left,bottom - top);
+}
+
+/// @brief invader rectangle in formation coordinates
+static sf::FloatRect localRectangle(const Invader& invader)
+{
+    const auto rectangle = invader.getRectangle();
+    return sf::FloatRect(invader.getDefaultPosition(),sf::Vector2f(rectangle.width,rectangle.height));
+}
+
+template<class Config>
+void Formation<Config>::reset()
+{
+    // invaders are linked in every column from the bottom to the top:
+    //  0  1  2 ...
+    // 10 11 12 ...
+    // ...
+    // 50 51 52 ... <- bottom
+    for(auto i = 0; i < invaders_in_grid; ++i)
+    {
+        above[i] = (i >= invaders_in_row) ? i - invaders_in_row : -1;
+        below[i] = (i + invaders_in_row < invaders_in_grid) ? i + invaders_in_row : -1;
+    }
+    for(auto column = 0; column < invaders_in_row; ++column)
+    {
+        bottom[column]       = invaders_in_grid - invaders_in_row + column;
+        live_columns[column] = column;
+        column_slot[column]  = column;
+    }
+    num_of_live_columns = invaders_in_row;
+}
+
+template<class Config>
+void Formation<Config>::removeInvader(int index, const Invaders& enemies)
+{
+    const auto column = index % invaders_in_row;
+    //unlink invader from its column
+    if(below[index] != -1){above[below[index]] = above[index];}
+    else{bottom[column] = above[index];}
+    if(above[index] != -1){below[above[index]] = below[index];}
+    above[index] = -1;
+    below[index] = -1;
+    //swap-remove empty column from live columns
+    if(bottom[column] == -1)
+    {
+        const auto slot = column_slot[column];
+        const auto last = live_columns[--num_of_live_columns];
+        live_columns[slot] = last;
+        column_slot[last]  = slot;
+    }
+    updateRowBounds(index/invaders_in_row,enemies);
+    updateColumnBounds(column,enemies);
+    updateFormationBounds();
+}
+
+template<class Config>
+void Formation<Config>::setupBounds(const Invaders& enemies)
+{
+    for(auto row = 0; row < rows_with_invaders; ++row){updateRowBounds(row,enemies);}
+    for(auto column = 0; column < invaders_in_row; ++column){updateColumnBounds(column,enemies);}
+    updateFormationBounds();
+    updateOffset(enemies);
+}
+
+template<class Config>
+void Formation<Config>::updateOffset(const Invaders& enemies)
+{
+    if(num_of_live_columns > 0)
+    {
+        const Invader& invader = enemies[getShooter(0)];
+        offset = invader.getPosition() - invader.getDefaultPosition();
+    }
+}
+
+template<class Config>
+void Formation<Config>::updateRowBounds(int row, const Invaders& enemies)
+{
+    row_bounds[row] = sf::FloatRect();
+    for(auto column = 0; column < invaders_in_row; ++column)
+    {
+        const Invader& invader = enemies[row*invaders_in_row + column];
+        if(invader.isVisible()){row_bounds[row] = unite(row_bounds[row],localRectangle(invader));}
+    }
+}
+
+template<class Config>
+void Formation<Config>::updateColumnBounds(int column, const Invaders& enemies)
+{
+    column_bounds[column] = sf::FloatRect();
+    for(auto row = 0; row < rows_with_invaders; ++row)
+    {
+        const Invader& invader = enemies[row*invaders_in_row + column];
+        if(invader.isVisible()){column_bounds[column] = unite(column_bounds[column],localRectangle(invader));}
+    }
+}
+
+template<class Config>
+void Formation<Config>::updateFormationBounds()
+{
+    bounds = sf::FloatRect();
+    for(const sf::FloatRect& row : row_bounds){bounds = unite(bounds,row);}
+}
+
+template class si::Formation<ClassicConfig>;
+template class si::Formation<StressConfig>;
+template class si::Formation<BenchmarkConfig>;
@@ -8,279 +8,466 @@
  */
 #include <ctime>
 #include <algorithm>
-#include <iostream>
+#include <cmath>
 #include "game.hpp"
+#include "mask.hpp"
+#include "alloc.hpp"
 
 using namespace si;
 
-Game::Game(unsigned int framerate)
+template<class Config>
+BasicGame<Config>::BasicGame():
+                particles(Config::particle_capacity)
 {
-    calculateItemsSpeed(framerate);
-    config.invader_shot_period  = framerate * invader_shot_period_s;
-    config.ship_spawn_period    = framerate * ship_spawn_period_s;
-    config.player_reload_period = framerate/4;
-    status                      = GameStatus::NotStarted;
+    status = GameStatus::NotStarted;
     setupInvaders();
     setupObstacles();
-    player       = std::make_unique<PlayerShip>(PlayerShip(sf::Vector2f(bottom_left_x,bottom_left_y),config.player_speed));
-    invader_ship = std::make_unique<InvaderShip>(InvaderShip(sf::Vector2f(default_border_size,default_border_size*2.f),config.enemy_ship_speed,false));
+    player       = std::make_unique<PlayerShip>(PlayerShip(sf::Vector2f(bottom_left_x,bottom_left_y),player_speed));
+    invader_ship = std::make_unique<InvaderShip>(InvaderShip(sf::Vector2f(default_border_size,default_border_size*2.f),enemy_ship_speed,false));
     player->setInitPosition(sf::Vector2f(bottom_left_x,bottom_left_y));
     player->setMotionVector(sf::Vector2f(bottom_left_x,bottom_left_y));
     //random generator used for enemy shot events
     randomizer.seed(std::time(nullptr));
     //create one invisible shell in shell vector to give possibility to setup texture and sprite
-    Shell shell(sf::Vector2f(0.f,0.f),config.shell_speed,ShellType::Enemy);
+    Shell shell(sf::Vector2f(0.f,0.f),shell_speed,ShellType::Enemy);
     shell.setVisibility(false);
+    bullets.reserve(Config::shells_reserve);
     bullets.push_back(shell);
+    live_shells.reserve(Config::shells_reserve);
+    live_invaders.resize(enemies.size());
+    live_obstacles.resize(obstacles.size());
+    live_shells.resize(bullets.size());
+    rebuildLiveLists();
 }
 
-void Game::gameLoop()
+template<class Config>
+void BasicGame<Config>::gameLoop()
 {
-    generateGameEvent();
-    controlItemsPosition();
-    checkCollision();
-    updateItemsPosition();
+    {
+        AllocationScope scope(AllocationStage::GameEvents);
+        generateGameEvent();
+    }
+    {
+        AllocationScope scope(AllocationStage::ItemsControl);
+        controlItemsPosition();
+    }
+    {
+        AllocationScope scope(AllocationStage::Collision);
+        PerfScope perf_scope(perf,PerfStage::Collision);
+        checkCollision();
+    }
+    {
+        AllocationScope scope(AllocationStage::ItemsUpdate);
+        PerfScope perf_scope(perf,PerfStage::ItemsUpdate);
+        updateItemsPosition();
+    }
+    if(effects)
+    {
+        AllocationScope scope(AllocationStage::Particles);
+        particles.update(tick_duration);
+    }
 }
 
-void Game::calculateItemsSpeed(const unsigned int framerate)
+template<class Config>
+void BasicGame<Config>::rebuildLiveLists()
 {
-    if(framerate != 0)
+    live_shells.resize(bullets.size());
+    auto rebuild = [](LiveIndex& list, const auto& items)
     {
-        config.enemy_ship_speed = default_ship_speed/framerate;
-        config.invader_speed    = default_invader_speed/framerate;
-        config.player_speed     = default_player_speed/framerate;
-        config.shell_speed      = default_shell_speed/framerate;
-    }
-    else{config = GameConfig();}
+        const auto num_of_items = items.size();
+        for(std::size_t i = 0; i < num_of_items; ++i)
+        {
+            const auto index = static_cast<std::uint32_t>(i);
+            if(items[i].isVisible()){list.revive(index);}
+            else{list.kill(index);}
+        }
+    };
+    rebuild(live_invaders,enemies);
+    rebuild(live_shells,bullets);
+    rebuild(live_obstacles,obstacles);
 }
 
-void si::Game::gameRestart()
+template<class Config>
+void BasicGame<Config>::gameRestart()
 {
     elements = GameElements();
+    particles.clear();
     spawnInvaders();
     spawnObstacles();
     status = GameStatus::Running;
+    //ship of previous game is removed, all delayed events start over
+    invader_ship->setVisibility(false);
+    timers.cancelAll();
+    schedule(GameTimer::InvaderShot,Config::invader_shot_period);
+    schedule(GameTimer::ShipSpawn,Config::ship_spawn_period);
+    emit(GameEventType::ScoreChanged,elements.score);
+    emit(GameEventType::LivesChanged,elements.player_lives);
 }
 
-void Game::setupInvaders()
+template<class Config>
+void BasicGame<Config>::setupInvaders()
 {
     constexpr float init_x = default_border_size;
     constexpr float init_y = default_border_size * 4.f;
     
-    if(enemies.empty())
+    Invader invader(sf::Vector2f(0.f,0.f),invader_speed,false);
+    invader.setTrajectory(trajectory.data(),static_cast<int>(trajectory.size()));
+    float offset_y = 0.f;
+    std::size_t index = 0;
+    for(auto j = 0; j < Config::rows_with_invaders; ++j)
     {
-        Invader invader(sf::Vector2f(0.f,0.f),config.invader_speed,false);
-        float offset_y = 0.f;
-        for(auto j = 0; j < rows_with_invaders; ++j)
+        float offset_x = 0.f;
+        for(auto i = 0; i < Config::invaders_in_row; ++i)
         {
-            float offset_x = 0.f;
-            for(auto i = 0; i < invaders_in_row; ++i)
-            {
-                invader.setInitPosition(sf::Vector2(init_x + offset_x,init_y + offset_y));
-                invader.setDefaultPosition();
-                enemies.push_back(invader);
-                offset_x += grid_row_step;
-            }
-            offset_y += grid_row_step;
+            invader.setInitPosition(sf::Vector2(init_x + offset_x,init_y + offset_y));
+            invader.setDefaultPosition();
+            enemies[index++] = invader;
+            offset_x += Config::grid_step;
         }
-        control.invaders_left = enemies.size();
+        offset_y += Config::grid_step;
     }
+    //invaders are hidden until first spawn
+    control.invaders_left = 0;
 }
 
-void Game::setupObstacles()
+template<class Config>
+void BasicGame<Config>::setupObstacles()
 {
-    // 4 structs with obstacles, 10*5 obstacles in struct , 2 rows, initial start 120, 900
-    constexpr int obstacles_in_row      = 10;
-    constexpr int struct_with_obstacles = 4;
-    constexpr float rows_with_obstacles = 5;
-    constexpr float init_x              = 120.f;
-    constexpr float init_y              = 900.f;
-
-    if(obstacles.empty())
+    // 4 structs with obstacles, 10*5 obstacles in struct, initial start 120, 900
+    constexpr float init_x = 120.f;
+    constexpr float init_y = 900.f;
+
+    sf::Vector2f init(init_x,init_y);
+    Obstacle obstacle(init);
+    sf::FloatRect rectangle = obstacle.getRectangle();
+    std::size_t index = 0;
+    for(auto i = 0; i < rows_with_obstacles; ++i)
     {
-        sf::Vector2f init(init_x,init_y);
-        Obstacle obstacle(init);
-        sf::FloatRect rectangle = obstacle.getRectangle();
-        for(auto i = 0; i < rows_with_obstacles; ++i)
+        for(auto j = 0; j < struct_with_obstacles; ++j)
         {
-            for(auto j = 0; j < struct_with_obstacles; ++j)
+            for(auto k = 0; k < obstacles_in_row; ++k)
             {
-                for(auto k = 0; k < obstacles_in_row; ++k)
-                {
-                    obstacle.setPosition(init);
-                    obstacles.push_back(obstacle);
-                    init.x += rectangle.width;
-                }
-                init.x += init_x;
+                obstacle.setPosition(init);
+                obstacles[index++] = obstacle;
+                init.x += rectangle.width;
             }
-            init.x  = init_x;
-            init.y -= rectangle.height;
-        } 
+            init.x += init_x;
+        }
+        init.x  = init_x;
+        init.y -= rectangle.height;
     }
 }
 
-void Game::spawnInvaders()
+template<class Config>
+void BasicGame<Config>::spawnInvaders()
 {
-    if(!enemies.empty())
+    for (Invader& enemy : enemies)
     {
-        for (Invader& enemy : enemies)
-        {
-            enemy.revertPosition();
-            enemy.setVisibility(true);
-        }
-        control.invaders_left = enemies.size();
+        enemy.revertPosition();
+        enemy.setVisibility(true);
     }
+    live_invaders.reviveAll();
+    formation.reset();
+    formation.setupBounds(enemies);
+    control.invaders_left = enemies.size();
 }
 
-void Game::spawnObstacles()
+template<class Config>
+void BasicGame<Config>::spawnObstacles()
 {
-    if(!obstacles.empty())
+    for(Obstacle& obstacle : obstacles)
     {
-        for(Obstacle& obstacle : obstacles)
-        {
-            obstacle.setVisibility(true);
-        }
+        obstacle.setVisibility(true);
     }
+    live_obstacles.reviveAll();
 }
 
-void Game::updateItemsPosition()
+template<class Config>
+void BasicGame<Config>::updateItemsPosition()
 {
     //update enemies
-    for (Invader& enemy : enemies){enemy.updatePosition();}
+    for (std::uint32_t index : live_invaders){enemies[index].updatePosition();}
+    formation.updateOffset(enemies);
     //update enemy ship
     invader_ship->updatePosition();
     //update bullets
-    for (Shell& shell : bullets){shell.updatePosition();}
+    for (std::uint32_t index : live_shells){bullets[index].updatePosition();}
     //update player ship
     player->updatePosition();    
 }
 
-void Game::generateGameEvent()
+template<class Config>
+void BasicGame<Config>::generateGameEvent()
 {
-    std::cout<<"invaders left : "<<control.invaders_left<<"\n";
-    //every tick for invaders shot event
-    ++control.invader_shot_counter;
-    //only if ship not spawned already
-    if(!control.invader_ship_spawned){++control.ship_spawn_counter;}
-    //only if player shot, reload delay
-    if(control.player_reload){++control.player_reload_counter;}
-    //random enemy shot every second
-    if((control.invader_shot_counter % config.invader_shot_period) == 0)
-    {
-        //std ::vector<Invader>::iterator last_enemy;
-        //last_enemy = std ::remove_if(enemies.begin(), enemies.end(),[](Invader& enemy){return !enemy.isVisible();});
-        //std::uniform_int_distribution<int> dist(0, std::distance(enemies.begin(), last_enemy) - 1);
-        std::uniform_int_distribution<int> dist(0, enemies.size() - 1);
-        auto index = dist(randomizer); 
-        if(enemies[index].isVisible())
-        {
-            const auto rectangle = enemies[index].getRectangle();
-            objectShot(rectangle,ShellType::Enemy);
-        }
-    }
-    //generate invader ship spawn event
-    if(((control.ship_spawn_counter % config.ship_spawn_period) == 0) && !control.invader_ship_spawned)
-    {
-        spawnInvaderShip();
-        control.ship_spawn_counter = 0;
-        control.invader_ship_spawned = true;
-    }
+    //delayed events, cost does not depend on number of pending timers
+    timers.advance([this](std::uint32_t timer){handleTimer(static_cast<GameTimer>(timer));});
     //player shot handle 
     if(player->getShotRequest())
     {
         player->setShotRequest(false);
         const auto rectangle = this->player->getRectangle();
-        sounds.shoot_sound.play();
         objectShot(rectangle,ShellType::Player);
     }
-    //player reload handle
-    if(((control.player_reload_counter % config.player_reload_period) == 0) && control.player_reload)
+}
+
+template<class Config>
+void BasicGame<Config>::handleTimer(GameTimer timer)
+{
+    switch(timer)
     {
-        control.player_reload = false;
+        case GameTimer::InvaderShot:
+            //enemy shot from the bottom-most invader of random live column
+            if(formation.getLiveColumns() > 0)
+            {
+                std::uniform_int_distribution<std::size_t> dist(0, formation.getLiveColumns() - 1);
+                const auto rectangle = enemies[formation.getShooter(dist(randomizer))].getRectangle();
+                objectShot(rectangle,ShellType::Enemy);
+            }
+            schedule(GameTimer::InvaderShot,Config::invader_shot_period);
+            break;
+
+        case GameTimer::ShipSpawn:
+            spawnInvaderShip();
+            break;
+
+        case GameTimer::WaveRespawn:
+            spawnInvaders();
+            break;
+
+        case GameTimer::PlayerReload:
+        default:
+            break;
     }
 }
 
-void Game::controlItemsPosition()
+template<class Config>
+void BasicGame<Config>::controlItemsPosition()
 {
-    //bullets control
-    for (Shell& shell : bullets)
+    //bullets control, list is walked from the end because removed shell is swapped
+    //with the last live one, which is already checked
+    for (std::size_t slot = live_shells.size(); slot > 0; --slot)
     {
-        if(shell.isVisible())
+        const auto index = live_shells[slot - 1];
+        auto position = bullets[index].getPosition();
+        if((position.x > default_x_size) || (position.x < default_start_x) ||
+           (position.y > default_y_size) || (position.y < default_start_y)
+          )
         {
-            auto position = shell.getRectangle().getPosition();
-            if((position.x > default_x_size) || (position.x < default_start_x) ||
-               (position.y > default_y_size) || (position.y < default_start_y)
-              )
-            {
-                shell.setVisibility(false);
-            }
+            removeShell(index);
         }
     }
     //enemy ship control
     if(invader_ship->isVisible())
     {
-        auto position = invader_ship->getRectangle().getPosition();
+        auto position = invader_ship->getPosition();
         if((position.x > default_x_size) || (position.x < default_start_x) ||
            (position.y > default_y_size) || (position.y < default_start_y)
           )
         {
-            sounds.ship_sound.stop();
             invader_ship->setVisibility(false);
-            control.invader_ship_spawned = false;
+            schedule(GameTimer::ShipSpawn,Config::ship_spawn_period);
+            emit(GameEventType::ShipLeft);
         }
     }
-    //spawn invaders again 
-    if(control.invaders_left == 0)
+}
+
+/// @brief swept test of moving rectangle against static one
+/// @param moving rectangle at the beginning of the tick
+/// @param motion displacement of moving rectangle during the tick
+/// @param target static rectangle
+/// @param entry_time normalized time of the first contact, 0 if rectangles already overlap
+/// @return true if rectangles touch each other during the tick
+static bool sweptIntersects(const sf::FloatRect& moving, const sf::Vector2f& motion, const sf::FloatRect& target, float& entry_time)
+{
+    // moving rectangle is reduced to its top left point and target is extended by moving rectangle size,
+    // then segment [0,1] of the point trajectory is clipped by target slabs
+    float t_enter = 0.f;
+    float t_exit  = 1.f;
+    auto clip = [&t_enter, &t_exit](float origin, float delta, float slab_min, float slab_max)
+    {
+        if(delta == 0.f){return (origin > slab_min) && (origin < slab_max);}
+        float t_min = (slab_min - origin)/delta;
+        float t_max = (slab_max - origin)/delta;
+        if(t_min > t_max){std::swap(t_min,t_max);}
+        t_enter = std::max(t_enter,t_min);
+        t_exit  = std::min(t_exit,t_max);
+        return t_enter < t_exit;
+    };
+
+    if(clip(moving.left,motion.x,target.left - moving.width,target.left + target.width) &&
+       clip(moving.top, motion.y,target.top - moving.height,target.top + target.height))
     {
-        //add logic for delay and music play
-        //spawnInvaders();
+        entry_time = t_enter;
+        return true;
     }
+    return false;
 }
 
-void Game::checkCollision()
+/// @brief swept test of moving rectangle against object, pixel mask of the object is tested
+/// after rectangles test passes, shells are expected to move vertically
+/// @param moving rectangle at the beginning of the tick
+/// @param motion displacement of moving rectangle during the tick
+/// @param target static object
+/// @param entry_time normalized time of the first contact
+/// @return true if moving rectangle touches solid pixels of object during the tick
+static bool sweptHits(const sf::FloatRect& moving, const sf::Vector2f& motion, const Object& target, float& entry_time)
 {
-    for (Shell& shell : bullets)
+    const auto rectangle = target.getRectangle();
+    if(!sweptIntersects(moving,motion,rectangle,entry_time)){return false;}
+    const si::CollisionMask* mask = target.getCollisionMask();
+    if(mask == nullptr){return true;}
+    //area covered by moving rectangle during the tick, in mask coordinates
+    const auto left   = static_cast<int>(std::floor(std::min(moving.left,moving.left + motion.x) - rectangle.left));
+    const auto right  = static_cast<int>(std::ceil(std::max(moving.left,moving.left + motion.x) + moving.width - rectangle.left));
+    const auto top    = static_cast<int>(std::floor(std::min(moving.top,moving.top + motion.y) - rectangle.top));
+    const auto bottom = static_cast<int>(std::ceil(std::max(moving.top,moving.top + motion.y) + moving.height - rectangle.top));
+    //first solid row in direction of motion
+    const auto row = mask->findRow(sf::IntRect(left,top,right - left,bottom - top),motion.y < 0.f);
+    if(row < 0){return false;}
+    if(motion.y < 0.f)
     {
-        if((shell.getShellType() == ShellType::Enemy) && (shell.isVisible() == true))
+        entry_time = std::max(entry_time,(moving.top - (rectangle.top + static_cast<float>(row + 1)))/(-motion.y));
+    }
+    else if(motion.y > 0.f)
+    {
+        entry_time = std::max(entry_time,(rectangle.top + static_cast<float>(row) - (moving.top + moving.height))/motion.y);
+    }
+    entry_time = std::min(entry_time,1.f);
+    return true;
+}
+
+template<class Config>
+void BasicGame<Config>::checkCollision()
+{
+    //detection only reads game state, all handlers are called in resolve pass
+    ContactList contacts(arena);
+    const auto num_of_shells = live_shells.size();
+    if(num_of_shells < parallel_threshold)
+    {
+        detectContacts(0,num_of_shells,contacts);
+    }
+    else
+    {
+        //counters of game thread would miss work of pool threads
+        if(perf){perf->skip();}
+        if(!pool)
+        {
+            pool = std::make_unique<ThreadPool>(collision_threads);
+            worker_contacts.resize(pool->getWorkers());
+        }
+        for(std::vector<Contact>& list : worker_contacts){list.clear();}
+        pool->parallelFor(num_of_shells,collision_grain,[this](std::size_t worker, std::size_t first, std::size_t last)
+        {
+            //stage is tracked per thread
+            AllocationScope scope(AllocationStage::Collision);
+            detectContacts(first,last,worker_contacts[worker]);
+        });
+        //merge order does not matter, resolve pass sorts contacts
+        std::size_t num_of_contacts = 0;
+        for(const std::vector<Contact>& list : worker_contacts){num_of_contacts += list.size();}
+        contacts.reserve(num_of_contacts);
+        for(const std::vector<Contact>& list : worker_contacts){contacts.insert(contacts.end(),list.begin(),list.end());}
+    }
+    resolveContacts(contacts);
+}
+
+template<class Config>
+template<class List>
+void BasicGame<Config>::detectContacts(std::size_t first, std::size_t last, List& contacts) const
+{
+    for (std::size_t slot = first; slot < last; ++slot)
+    {
+        const auto index   = live_shells[slot];
+        const Shell& shell = bullets[index];
+        //targets are treated as static during one tick, shell is swept along its path
+        //to prevent tunneling through thin items at low tick rates
+        const auto rectangle = shell.getRectangle();
+        const auto motion    = shell.getVelocity();
+        float time;
+
+        if(shell.getShellType() == ShellType::Enemy)
         {
             //collision between enemy shells and player ship
-            if(player->getRectangle().intersects(shell.getRectangle()))
+            if(sweptHits(rectangle,motion,*player,time))
             {
-                handlePlayerHit();
+                contacts.push_back(Contact{time,index,0,ContactKind::Player});
             }
         }
-
-        if((shell.getShellType() == ShellType::Player) && (shell.isVisible() == true))
+        else
         {
-            //collision between player shells and invaders
-            for (Invader& enemy : enemies)
+            //collision between player shells and invaders, only rows and columns
+            //overlapped by the shell path are tested
+            const sf::FloatRect path(std::min(rectangle.left,rectangle.left + motion.x),
+                                     std::min(rectangle.top,rectangle.top + motion.y),
+                                     rectangle.width + std::abs(motion.x),
+                                     rectangle.height + std::abs(motion.y));
+            formation.forEachCandidate(path,[&](int target)
             {
-
-                if((enemy.isVisible() == true) && (shell.getRectangle().intersects(enemy.getRectangle()) == true))
+                const Invader& enemy = enemies[target];
+                if((enemy.isVisible() == true) && sweptHits(rectangle,motion,enemy,time))
                 {
-                    handleInvaderHit(shell,enemy);
-                    if(control.invaders_left == 0){break;}
+                    contacts.push_back(Contact{time,index,static_cast<std::uint32_t>(target),ContactKind::Invader});
                 }
-            }
+            });
             //collision between player shells and invader ship
-            if((invader_ship->isVisible() == true) && (shell.getRectangle().intersects(invader_ship->getRectangle()) == true))
+            if((invader_ship->isVisible() == true) && sweptHits(rectangle,motion,*invader_ship,time))
             {
-                handleShipHit(shell);
+                contacts.push_back(Contact{time,index,0,ContactKind::InvaderShip});
             }
         }
         //collision between shells and player obstacles
-        for (Obstacle& obstacle : obstacles)
+        for (std::uint32_t target : live_obstacles)
         {
-            if((obstacle.isVisible() == true)&& (shell.getRectangle().intersects(obstacle.getRectangle()) == true))
+            if(sweptHits(rectangle,motion,obstacles[target],time))
             {
-                obstacle.setVisibility(false);
-                shell.setVisibility(false);
+                contacts.push_back(Contact{time,index,target,ContactKind::Obstacle});
             }
         }
     }
 }
 
-void Game::executeEvent(const sf::Event &event)
+template<class Config>
+void BasicGame<Config>::resolveContacts(ContactList& contacts)
+{
+    std::sort(contacts.begin(),contacts.end(),[](const Contact& a, const Contact& b)
+    {
+        if(a.time != b.time){return a.time < b.time;}
+        if(a.shell != b.shell){return a.shell < b.shell;}
+        if(a.kind != b.kind){return a.kind < b.kind;}
+        return a.target < b.target;
+    });
+    //shell or target may be already removed by earlier contact, so the earliest
+    //valid contact of every shell wins
+    for(const Contact& contact : contacts)
+    {
+        if(live_shells.isLive(contact.shell) == false){continue;}
+        Shell& shell = bullets[contact.shell];
+        switch(contact.kind)
+        {
+            case ContactKind::Player:
+                handlePlayerHit();
+                break;
+
+            case ContactKind::Invader:
+                if(live_invaders.isLive(contact.target)){handleInvaderHit(shell,enemies[contact.target]);}
+                break;
+
+            case ContactKind::InvaderShip:
+                if(invader_ship->isVisible()){handleShipHit(shell);}
+                break;
+
+            case ContactKind::Obstacle:
+                if(live_obstacles.isLive(contact.target)){handleObstacleHit(shell,obstacles[contact.target]);}
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+template<class Config>
+void BasicGame<Config>::executeEvent(const sf::Event &event)
 {
     switch (event.type)
     {
@@ -299,7 +486,7 @@ void Game::executeEvent(const sf::Event &event)
 
                 case sf::Keyboard::Key::Right:
                     control.right_pressed = true;
-                    player->setMotionVector(sf::Vector2f(bottom_right_x - static_cast<float>(player->getSprite().getTextureRect().width),bottom_right_y));
+                    player->setMotionVector(sf::Vector2f(bottom_right_x - static_cast<float>(player->getTextureRect().width),bottom_right_y));
                     break;
 
                 case sf::Keyboard::Key::Space:
@@ -310,10 +497,10 @@ void Game::executeEvent(const sf::Event &event)
                             break;
                         
                         case GameStatus::Running:
-                            if(control.player_reload == false)
+                            if(!timers.isPending(static_cast<std::uint32_t>(GameTimer::PlayerReload)))
                             {
                                 player->setShotRequest(true);
-                                control.player_reload = true;
+                                schedule(GameTimer::PlayerReload,Config::player_reload_period);
                             }
                             break;
                         
@@ -345,7 +532,7 @@ void Game::executeEvent(const sf::Event &event)
             }
             if((control.left_pressed == false) && (control.right_pressed == false))
             {
-                player->setMotionVector(player->getRectangle().getPosition());
+                player->setMotionVector(player->getPosition());
             }
             break;
 
@@ -354,72 +541,121 @@ void Game::executeEvent(const sf::Event &event)
     }
 }
 
-void Game::handlePlayerHit()
+template<class Config>
+void BasicGame<Config>::handlePlayerHit()
 {
     //remove all shells from canvas
-    for (Shell& shell : bullets){shell.setVisibility(false);}
+    for (std::uint32_t index : live_shells){bullets[index].setVisibility(false);}
+    live_shells.killAll();
+    emitDebris(player->getRectangle(),player_debris,sf::Color(40,236,250));
     if(elements.player_lives > 0)
     {
-        sounds.player_killed_sound.play();
         //decrease player lives counter
         --elements.player_lives;
+        emit(GameEventType::LifeLost,elements.player_lives);
+        emit(GameEventType::LivesChanged,elements.player_lives);
         //move player to default position
         player->setDefaultPosition();
         player->setMotionVector(sf::Vector2f(bottom_left_x,bottom_left_y));
-        control.invader_shot_counter = 0;
+        schedule(GameTimer::InvaderShot,Config::invader_shot_period);
+    }
+    else
+    {
+        status = GameStatus::GameOver;
+        emit(GameEventType::GameOver);
     }
-    else{status = GameStatus::GameOver;}
 }
 
-void si::Game::handleShipHit(Shell &shell)
+template<class Config>
+void BasicGame<Config>::handleShipHit(Shell &shell)
 {
-    shell.setVisibility(false);
+    removeShell(static_cast<std::uint32_t>(&shell - &bullets[0]));
     invader_ship->setVisibility(false);
-    sounds.ship_sound.stop();
-    control.invader_ship_spawned = false;
+    schedule(GameTimer::ShipSpawn,Config::ship_spawn_period);
     elements.score += invader_ship_reward;
+    emit(GameEventType::ShipKilled);
+    emit(GameEventType::ScoreChanged,elements.score);
 }
 
-void si::Game::handleInvaderHit(Shell &shell, Invader &invader)
+template<class Config>
+void BasicGame<Config>::handleInvaderHit(Shell &shell, Invader &invader)
 {
-    shell.setVisibility(false);
+    removeShell(static_cast<std::uint32_t>(&shell - &bullets[0]));
     invader.setVisibility(false);
-    sounds.invader_killed_sound.play();
-    control.invaders_left--;
+    const auto index = static_cast<int>(&invader - &enemies[0]);
+    live_invaders.kill(static_cast<std::uint32_t>(index));
+    formation.removeInvader(index,enemies);
+    emitDebris(invader.getRectangle(),invader_debris,sf::Color::White);
+    //next wave comes after a pause
+    if(--control.invaders_left == 0){schedule(GameTimer::WaveRespawn,Config::wave_respawn_delay);}
     elements.score += invader_reward;
+    emit(GameEventType::InvaderKilled,index);
+    emit(GameEventType::ScoreChanged,elements.score);
+}
+
+template<class Config>
+void BasicGame<Config>::handleObstacleHit(Shell &shell, Obstacle &obstacle)
+{
+    removeShell(static_cast<std::uint32_t>(&shell - &bullets[0]));
+    obstacle.setVisibility(false);
+    live_obstacles.kill(static_cast<std::uint32_t>(&obstacle - &obstacles[0]));
+}
+
+template<class Config>
+void BasicGame<Config>::removeShell(std::uint32_t index)
+{
+    bullets[index].setVisibility(false);
+    live_shells.kill(index);
+}
+
+template<class Config>
+void BasicGame<Config>::emitDebris(const sf::FloatRect& rectangle, std::size_t count, const sf::Color& color)
+{
+    if(!effects){return;}
+    particles.emit(sf::Vector2f(rectangle.left + rectangle.width/2.f,rectangle.top + rectangle.height/2.f),count,color);
 }
 
-void Game::spawnInvaderShip()
+template<class Config>
+void BasicGame<Config>::spawnInvaderShip()
 {
     invader_ship->setDefaultPosition();
     invader_ship->setVisibility(true);
-    sounds.ship_sound.play();
+    emit(GameEventType::ShipSpawned);
 }
 
-void Game::objectShot(const sf::FloatRect &rectangle, const ShellType shell_type)
+template<class Config>
+void BasicGame<Config>::objectShot(const sf::FloatRect &rectangle, const ShellType shell_type)
 {
     //we are going to shut from the middle of the object
     sf::Vector2f position;     
     position.x = rectangle.getPosition().x + rectangle.width/2.0f;
     position.y = rectangle.getPosition().y + rectangle.height/2.0f;
+    emit(GameEventType::Shot,static_cast<std::int32_t>(shell_type));
     //check if we have available shells in array(that was already created and executed)
-    auto it = std::find_if(bullets.begin(),bullets.end(),[]( Shell& shell){return shell.isVisible() == false;} );
-    if(it != bullets.end())
+    if(live_shells.size() < live_shells.capacity())
     {
         //use existed one
-        it->setShellType(shell_type);
-        it->setPosition(position);
-        it->setVisibility(true);
+        const auto index = live_shells.getDead();
+        Shell& shell = bullets[index];
+        shell.setShellType(shell_type);
+        shell.setPosition(position);
+        shell.setVisibility(true);
+        live_shells.revive(index);
     }
     else
     {
-        //create new one
-        Shell shell(position,config.shell_speed,shell_type);
-        //we expect that one shell always exist in bullets vector
-        const sf::Texture* shell_texture = bullets[0].getSprite().getTexture();
-        const sf::Color shell_color      = bullets[0].getSprite().getColor();
-        shell.setTexture(*shell_texture);
-        shell.setSpriteColor(shell_color);
+        //create new one, we expect that one shell always exist in bullets vector,
+        //texture, color and rectangle are copied from it, texture may be not set in headless mode
+        Shell shell(bullets[0]);
+        shell.setShellType(shell_type);
+        shell.setPosition(position);
+        shell.setVisibility(true);
         bullets.push_back(shell);
+        live_shells.resize(bullets.size());
+        live_shells.revive(static_cast<std::uint32_t>(bullets.size() - 1));
     }
 }
+
+template class si::BasicGame<ClassicConfig>;
+template class si::BasicGame<StressConfig>;
+template class si::BasicGame<BenchmarkConfig>;
@@ -0,0 +1,90 @@
+/**
+ * @file governor.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include "governor.hpp"
+
+using namespace std::chrono;
+
+struct GovernorLevel
+{
+    /// @brief part of explosion particles
+    float particle_density;
+    /// @brief minimal number of frames between HUD text rebuilds
+    unsigned int hud_refresh_period;
+    /// @brief description for log
+    const char* description;
+};
+
+//optional work is shed from the least visible one
+static const std::array<GovernorLevel,governor_levels> levels = 
+{{
+    {1.0f, 1,                   "full quality"},
+    {0.5f, 1,                   "particle density 50%"},
+    {0.5f, governor_hud_period, "particle density 50%, HUD text throttled"},
+    {0.0f, governor_hud_period, "particles off, HUD text throttled"}
+}};
+
+FrameGovernor::FrameGovernor(const unsigned int framerate, std::ostream* log):
+                budget(duration_cast<clock::duration>(seconds(1)) / std::max(framerate,1u)),
+                log(log)
+{
+}
+
+void FrameGovernor::recordFrame(clock::duration work_time)
+{
+    ++frames;
+    ++level_frames[level];
+    ++window_frames;
+    if(work_time > budget){++window_over;}
+    window_worst = std::max(window_worst,work_time);
+    if(window_frames < governor_window){return;}
+    //one decision per window, so every level is measured for a full window before next change
+    auto next = level;
+    if((window_over >= governor_shed_frames) && (level < governor_levels - 1)){next = level + 1;}
+    else if((window_worst < budget*governor_restore_ratio) && (level > 0)){next = level - 1;}
+    if(log){logDecision(next);}
+    if(next != level)
+    {
+        ++level_changes;
+        level = next;
+    }
+    window_frames = 0;
+    window_over   = 0;
+    window_worst  = clock::duration::zero();
+}
+
+float FrameGovernor::getParticleDensity() const
+{
+    return levels[level].particle_density;
+}
+
+unsigned int FrameGovernor::getHudRefreshPeriod() const
+{
+    return levels[level].hud_refresh_period;
+}
+
+void FrameGovernor::printStatistics(std::ostream& stream) const
+{
+    stream<<"frame governor ("<<frames<<" frames, "<<level_changes<<" level changes):\n";
+    for(auto i = 0; i < governor_levels; ++i)
+    {
+        if(level_frames[i] == 0){continue;}
+        stream<<"  level "<<i<<" ("<<levels[i].description<<") : "<<level_frames[i]<<" frames\n";
+    }
+}
+
+void FrameGovernor::logDecision(int next) const
+{
+    *log<<"governor: frame "<<frames<<", "<<window_over<<" of "<<window_frames<<" frames over "
+        <<duration_cast<microseconds>(budget).count()<<" us budget, worst "
+        <<duration_cast<microseconds>(window_worst).count()<<" us, ";
+    if(next == level){*log<<"hold level "<<level;}
+    else{*log<<((next > level) ? "shed" : "restore")<<" level "<<level<<" -> "<<next;}
+    *log<<": "<<levels[next].description<<"\n";
+}
@@ -0,0 +1,74 @@
+/**
+ * @file headless.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <array>
+#include <stdexcept>
+#include "headless.hpp"
+#include "mask.hpp"
+
+using namespace si;
+
+//invader images in order of rows, same as in Canvas::setupTextures
+static const std::array<std::string,3> invader_images = 
+{
+    std::string("rc/textures/green.png"),
+    std::string("rc/textures/red.png"),
+    std::string("rc/textures/yellow.png")
+};
+
+struct HeadlessItem
+{
+    /// @brief sprite rectangle
+    sf::IntRect rectangle;
+    /// @brief collision mask
+    CollisionMask mask;
+};
+
+//masks are shared by all headless game instances
+static std::array<HeadlessItem,3> invader_items;
+static HeadlessItem player_item;
+static HeadlessItem ship_item;
+
+static void loadItem(const std::string& path, HeadlessItem& item)
+{
+    sf::Image image;
+    if(!image.loadFromFile(path))
+    {
+        throw std::runtime_error(std::string("Could not load resource files!"));
+    }
+    const auto size = image.getSize();
+    item.rectangle  = sf::IntRect(0,0,static_cast<int>(size.x),static_cast<int>(size.y));
+    item.mask       = CollisionMask(image);
+}
+
+template<class GameType>
+void si::setupHeadlessItems(GameType& game)
+{
+    for(std::size_t i = 0; i < invader_images.size(); ++i){loadItem(invader_images[i],invader_items[i]);}
+    loadItem("rc/textures/player.png",player_item);
+    loadItem("rc/textures/extra.png",ship_item);
+    int num_of_invaders = game.enemies.size();
+    for(auto i = 0; i < num_of_invaders; ++i)
+    {
+        const HeadlessItem& item = invader_items[(i/GameType::config_type::invaders_in_row) % invader_items.size()];
+        game.enemies[i].setSpriteRectangle(item.rectangle);
+        game.enemies[i].setCollisionMask(&item.mask);
+    }
+    game.player->setSpriteRectangle(player_item.rectangle);
+    game.player->setCollisionMask(&player_item.mask);
+    game.invader_ship->setSpriteRectangle(ship_item.rectangle);
+    game.invader_ship->setCollisionMask(&ship_item.mask);
+    //first shell is the template of all new shells, same color as in Canvas::setupTextures
+    game.bullets[0].setSpriteColor(sf::Color(40, 236, 250));
+    //nothing is rendered, explosion particles are not needed
+    game.setEffects(false);
+}
+
+template void si::setupHeadlessItems(Game& game);
+template void si::setupHeadlessItems(StressGame& game);
+template void si::setupHeadlessItems(BenchmarkGame& game);
@@ -27,24 +27,11 @@ void Invader::updatePosition()
 {
     if(isVisible())
     {
-        // Invader trajectory:
-        //  450 steps
-        // ---------->
-        // |         |   
-        // |         | 20 steps
-        // <---------|
-        const int step_x = 450;
-        const int step_y = 20;
-
-        auto speed = getSpeed();
-        sf::Vector2 vector(0.f,0.f);
-        if(position_counter < step_x)                     {vector.x = speed;}
-        else if (position_counter < (step_x + step_y))    {vector.y = speed;}
-        else if (position_counter < (2*step_x + step_y))  {vector.x = (-1.f)*speed;}
-        else if (position_counter < (2*step_x + 2*step_y)){vector.y = (-1.f)*speed;}
-        ++position_counter;
-        move(vector);
-        if(position_counter == (2*step_x + 2*step_y)){revertPosition();}
+        // Invader trajectory is precomputed by game variant, see makeInvaderTrajectory
+        const TrajectoryStep step = trajectory[position_counter];
+        const auto speed = getSpeed();
+        move(sf::Vector2f(speed*step.x,speed*step.y));
+        if(++position_counter == trajectory_length){revertPosition();}
     }
 }
 
@@ -84,16 +71,18 @@ Shell::Shell(sf::Vector2f position, float speed, ShellType shell_type) : shell_t
     setSpriteRectangle(sf::IntRect(0, 0, shell_width, shell_height));
 }
 
-void Shell::updatePosition()
+sf::Vector2f Shell::getVelocity() const
 {
     // shell trajectory:
     // straight up or down from the creation point
-    if(isVisible())
-    {
-        sf::Vector2 vector(0.f,getSpeed());
-        if(shell_type == ShellType::Player){vector.y *= (-1.f);}    
-        move(vector); 
-    }     
+    sf::Vector2 vector(0.f,getSpeed());
+    if(shell_type == ShellType::Player){vector.y *= (-1.f);}
+    return vector;
+}
+
+void Shell::updatePosition()
+{
+    if(isVisible()){move(getVelocity());}
 }
 
 PlayerShip::PlayerShip(sf::Vector2f position, float speed): shot_request(false)
@@ -120,7 +109,7 @@ void PlayerShip::updatePosition()
     if(isVisible())
     {
         sf::Vector2 vector(0.f,0.f);
-        auto position = getRectangle().getPosition();   
+        auto position = getPosition();   
         auto speed    = getSpeed();
         if(position != motion_vector)
         {
@@ -0,0 +1,41 @@
+/**
+ * @file live.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include "live.hpp"
+
+using namespace si;
+
+void LiveIndex::resize(std::size_t capacity)
+{
+    //entities are never removed, new entities are placed after all dead ones
+    for(std::size_t index = dense.size(); index < capacity; ++index)
+    {
+        dense.push_back(static_cast<std::uint32_t>(index));
+        position.push_back(index);
+    }
+}
+
+void LiveIndex::revive(std::uint32_t index)
+{
+    if(position[index] >= live){swap(position[index],live++);}
+}
+
+void LiveIndex::kill(std::uint32_t index)
+{
+    if(position[index] < live){swap(position[index],--live);}
+}
+
+void LiveIndex::swap(std::size_t a, std::size_t b)
+{
+    const auto index_a = dense[a];
+    const auto index_b = dense[b];
+    dense[a]          = index_b;
+    dense[b]          = index_a;
+    position[index_a] = b;
+    position[index_b] = a;
+}
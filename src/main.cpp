@@ -7,13 +7,124 @@
  *
  */
 
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
 #include "canvas.hpp"
+#include "autopilot.hpp"
 
-constexpr unsigned int framerate = 60;
+//canvas shows classic game variant, one frame per simulation tick
+constexpr unsigned int framerate = si::Game::tickrate;
 
-int main()
+int main(int argc, char* argv[])
 {
-    Canvas canvas(framerate);
-    canvas.runEventLoop();
+    enum class Mode
+    {
+        Local,
+        Server,
+        Client,
+        Soak
+    };
+
+    Mode mode            = Mode::Local;
+    CanvasOptions options;
+    unsigned short port  = si::default_server_port;
+    std::string address  = "127.0.0.1";
+    std::uint64_t ticks  = 0;
+    si::SoakOptions soak;
+    auto next_argument   = [&](int& i){return (i + 1 < argc) ? argv[++i] : "";};
+    for(auto i = 1; i < argc; ++i)
+    {
+        //skip spin-wait in frame pacer
+        if(std::strcmp(argv[i],"--power-saving") == 0){options.power_saving = true;}
+        //measure first text frames without glyph cache prewarm
+        else if(std::strcmp(argv[i],"--no-glyph-prewarm") == 0){options.glyph_prewarm = false;}
+        //keep all optional work on slow frames
+        else if(std::strcmp(argv[i],"--no-governor") == 0){options.governor = false;}
+        //print frame governor decision of every 30 frame window
+        else if(std::strcmp(argv[i],"--governor-log") == 0){options.governor_log = true;}
+        //hardware counters of game stages, printed on exit
+        else if(std::strcmp(argv[i],"--perf-counters") == 0)
+        {
+            options.perf_counters = true;
+            soak.perf_counters    = true;
+        }
+        //write every frame to image sequence in given directory
+        else if(std::strcmp(argv[i],"--capture") == 0){options.capture.directory = next_argument(i);}
+        else if(std::strcmp(argv[i],"--capture-png") == 0){options.capture.format = si::CaptureFormat::Png;}
+        //read back captured frames with glReadPixels into client memory, without pixel buffer objects
+        else if(std::strcmp(argv[i],"--capture-sync") == 0){options.capture.async_readback = false;}
+        //defer audio device initialization until first sound
+        else if(std::strcmp(argv[i],"--lazy-audio") == 0){options.lazy_audio = true;}
+        //stream background music from rc/music
+        else if(std::strcmp(argv[i],"--music") == 0)
+        {
+            options.music = true;
+            soak.music    = true;
+        }
+        //headless authoritative server
+        else if(std::strcmp(argv[i],"--server") == 0){mode = Mode::Server;}
+        //render game from server snapshots
+        else if(std::strcmp(argv[i],"--client") == 0)
+        {
+            mode    = Mode::Client;
+            address = next_argument(i);
+        }
+        else if(std::strcmp(argv[i],"--port") == 0){port = static_cast<unsigned short>(std::atoi(next_argument(i)));}
+        //headless game driven by autopilot
+        else if(std::strcmp(argv[i],"--autopilot") == 0){mode = Mode::Soak;}
+        else if(std::strcmp(argv[i],"--aggression") == 0){soak.aggression = std::strtof(next_argument(i),nullptr);}
+        else if(std::strcmp(argv[i],"--seed") == 0){soak.seed = static_cast<std::uint32_t>(std::strtoul(next_argument(i),nullptr,10));}
+        else if(std::strcmp(argv[i],"--realtime") == 0){soak.realtime = true;}
+        //compile-time game variant for autopilot: classic, stress or benchmark
+        else if(std::strcmp(argv[i],"--variant") == 0)
+        {
+            const std::string variant = next_argument(i);
+            if(variant == "stress"){soak.variant = si::GameVariant::Stress;}
+            else if(variant == "benchmark"){soak.variant = si::GameVariant::Benchmark;}
+            else{soak.variant = si::GameVariant::Classic;}
+        }
+        //autopilot runs collision detection on thread pool from given number of live shells, 0 for every tick
+        else if(std::strcmp(argv[i],"--parallel-collision") == 0)
+        {
+            soak.parallel_collision = true;
+            soak.parallel_threshold = std::strtoull(next_argument(i),nullptr,10);
+        }
+        //fail autopilot run on any allocation after given number of warm-up ticks
+        else if(std::strcmp(argv[i],"--check-allocations") == 0){soak.allocation_warmup = std::strtoull(next_argument(i),nullptr,10);}
+        //number of server or autopilot ticks, both run forever by default
+        else if(std::strcmp(argv[i],"--ticks") == 0){ticks = std::strtoull(next_argument(i),nullptr,10);}
+    }
+
+    switch(mode)
+    {
+        case Mode::Server:
+        {
+            si::Server server(port);
+            server.run(ticks);
+            break;
+        }
+        case Mode::Soak:
+        {
+            soak.ticks = ticks;
+            if(!si::runSoak(soak,std::cout)){return EXIT_FAILURE;}
+            break;
+        }
+        case Mode::Client:
+        {
+            si::Client client(sf::IpAddress(address),port);
+            Canvas canvas(framerate,options,&client);
+            canvas.runEventLoop();
+            break;
+        }
+        case Mode::Local:
+        default:
+        {
+            Canvas canvas(framerate,options);
+            canvas.runEventLoop();
+            break;
+        }
+    }
     return 0;
 }
\ No newline at end of file
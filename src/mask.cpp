@@ -0,0 +1,64 @@
+/**
+ * @file mask.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include "mask.hpp"
+
+using namespace si;
+
+CollisionMask::CollisionMask(const sf::Image& image)
+{
+    const auto size = image.getSize();
+    width         = static_cast<int>(size.x);
+    height        = static_cast<int>(size.y);
+    words_per_row = (width + 63)/64;
+    bits.assign(static_cast<std::size_t>(words_per_row)*height,0);
+    //RGBA pixels, alpha is the fourth byte
+    const sf::Uint8* pixels = image.getPixelsPtr();
+    for(auto y = 0; y < height; ++y)
+    {
+        for(auto x = 0; x < width; ++x)
+        {
+            if(pixels[(static_cast<std::size_t>(y)*width + x)*4 + 3] > mask_alpha_threshold)
+            {
+                bits[static_cast<std::size_t>(y)*words_per_row + x/64] |= std::uint64_t(1) << (x % 64);
+            }
+        }
+    }
+}
+
+int CollisionMask::findRow(const sf::IntRect& area, bool from_bottom) const
+{
+    const int left   = std::max(area.left,0);
+    const int right  = std::min(area.left + area.width,width);
+    const int top    = std::max(area.top,0);
+    const int bottom = std::min(area.top + area.height,height);
+    if((left >= right) || (top >= bottom)){return -1;}
+
+    //area columns as a bit span over row words
+    const int first_word = left/64;
+    const int last_word  = (right - 1)/64;
+    auto span = [&](int word)
+    {
+        const int from = std::max(left - word*64,0);
+        const int to   = std::min(right - word*64,64);
+        const std::uint64_t upper = (to == 64) ? ~std::uint64_t(0) : ((std::uint64_t(1) << to) - 1);
+        return upper & ~((std::uint64_t(1) << from) - 1);
+    };
+
+    for(int i = 0; i < bottom - top; ++i)
+    {
+        const int row = from_bottom ? (bottom - 1 - i) : (top + i);
+        const std::uint64_t* words = &bits[static_cast<std::size_t>(row)*words_per_row];
+        for(int word = first_word; word <= last_word; ++word)
+        {
+            if(words[word] & span(word)){return row;}
+        }
+    }
+    return -1;
+}
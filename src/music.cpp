@@ -0,0 +1,270 @@
+/**
+ * @file music.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+#include "music.hpp"
+#include "alloc.hpp"
+
+using namespace si;
+
+const std::array<std::string,num_of_tracks> si::music_files = 
+{
+    std::string("rc/music/welcome.ogg"),
+    std::string("rc/music/game.ogg"),
+    std::string("rc/music/game_over.ogg")
+};
+
+FileMusicSource::FileMusicSource(const std::string& path)
+{
+    if(!file.openFromFile(path))
+    {
+        throw std::runtime_error(std::string("Could not load resource files!"));
+    }
+}
+
+std::size_t FileMusicSource::read(std::int16_t* samples, std::size_t count)
+{
+    return static_cast<std::size_t>(file.read(samples,sf::Uint64(count)));
+}
+
+MusicSources si::openMusicFiles(const std::array<std::string,num_of_tracks>& files)
+{
+    MusicSources sources;
+    for(std::size_t i = 0; i < num_of_tracks; ++i)
+    {
+        sources[i] = std::make_unique<FileMusicSource>(files[i]);
+    }
+    return sources;
+}
+
+MusicTrack si::getMusicTrack(GameStatus status)
+{
+    switch(status)
+    {
+        case GameStatus::NotStarted:
+            return MusicTrack::Welcome;
+        case GameStatus::Running:
+            return MusicTrack::Game;
+        case GameStatus::GameOver:
+            return MusicTrack::GameOver;
+        case GameStatus::Closed:
+        default:
+            return MusicTrack::None;
+    }
+}
+
+void SampleRing::allocate(std::size_t capacity)
+{
+    samples.assign(capacity,0);
+    mask = capacity - 1;
+}
+
+std::size_t SampleRing::write(const std::int16_t* source, std::size_t count)
+{
+    const auto position = head.load(std::memory_order_relaxed);
+    count = std::min(count,samples.size() - (position - tail.load(std::memory_order_acquire)));
+    //copy may wrap around the end of storage
+    const auto first = std::min(count,samples.size() - (position & mask));
+    std::copy(source,source + first,samples.begin() + (position & mask));
+    std::copy(source + first,source + count,samples.begin());
+    head.store(position + count,std::memory_order_release);
+    return count;
+}
+
+std::size_t SampleRing::read(std::int16_t* destination, std::size_t count)
+{
+    const auto position = tail.load(std::memory_order_relaxed);
+    count = std::min(count,head.load(std::memory_order_acquire) - position);
+    const auto first = std::min(count,samples.size() - (position & mask));
+    std::copy(samples.begin() + (position & mask),samples.begin() + (position & mask) + first,destination);
+    std::copy(samples.begin(),samples.begin() + (count - first),destination + first);
+    tail.store(position + count,std::memory_order_release);
+    return count;
+}
+
+std::size_t SampleRing::getSpace() const
+{
+    return samples.size() - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+}
+
+MusicStream::MusicStream(MusicSources sources):
+                sources(std::move(sources)),
+                decoded(music_block_samples),
+                mixed(music_block_samples),
+                block(music_block_samples)
+{
+    for(const auto& source : this->sources)
+    {
+        if(!source)
+        {
+            throw std::runtime_error(std::string("Music track is missing!"));
+        }
+        const auto channels = source->getChannelCount();
+        const auto rate     = source->getSampleRate();
+        if((channels == 0) || (channels > music_channels) || (rate == 0) || ((sample_rate != 0) && (rate != sample_rate)))
+        {
+            throw std::runtime_error(std::string("Music tracks shall be mono or stereo with same sample rate!"));
+        }
+        sample_rate = rate;
+    }
+    //ring is sized by time, so track changes are heard after the same delay at every sample rate
+    const auto ring_samples = static_cast<std::size_t>(music_ring_s*static_cast<float>(sample_rate*music_channels));
+    std::size_t capacity    = 2*music_block_samples;
+    while(capacity*2 <= ring_samples){capacity *= 2;}
+    ring.allocate(capacity);
+    thread = std::thread([this]{decodeLoop();});
+}
+
+MusicStream::~MusicStream()
+{
+    running.store(false,std::memory_order_relaxed);
+    thread.join();
+}
+
+void MusicStream::read(std::int16_t* samples, std::size_t count)
+{
+    const auto ready = ring.read(samples,count);
+    if(ready < count)
+    {
+        std::fill(samples + ready,samples + count,std::int16_t(0));
+        underruns.fetch_add(1,std::memory_order_relaxed);
+    }
+}
+
+void MusicStream::decodeLoop()
+{
+    AllocationScope scope(AllocationStage::Music);
+    while(running.load(std::memory_order_relaxed))
+    {
+        switchTrack(requested.load(std::memory_order_relaxed));
+        if(ring.getSpace() < music_block_samples)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(music_idle_period_ms));
+            continue;
+        }
+        //silence is written too, so output never waits for decoder between tracks
+        mixBlock(music_block_samples/music_channels);
+        ring.write(block.data(),music_block_samples);
+    }
+}
+
+void MusicStream::switchTrack(MusicTrack track)
+{
+    const auto fade_step = 1.f/(music_crossfade_s*static_cast<float>(sample_rate));
+    //voice that fades in or plays at full gain
+    const auto current = std::find_if(voices.begin(),voices.end(),[](const Voice& voice)
+    {
+        return (voice.track != MusicTrack::None) && (voice.step > 0.f);
+    });
+    if((current != voices.end()) && (current->track == track)){return;}
+    if((current == voices.end()) && (track == MusicTrack::None)){return;}
+    for(Voice& voice : voices)
+    {
+        if(voice.track != MusicTrack::None){voice.step = -fade_step;}
+    }
+    if(track == MusicTrack::None){return;}
+    //track that fades out is faded back in, otherwise it restarts on a free voice
+    auto next = std::find_if(voices.begin(),voices.end(),[track](const Voice& voice){return voice.track == track;});
+    if(next == voices.end())
+    {
+        next = std::find_if(voices.begin(),voices.end(),[](const Voice& voice){return voice.track == MusicTrack::None;});
+    }
+    if(next == voices.end())
+    {
+        //both voices are busy, the quieter one is cut
+        next = std::min_element(voices.begin(),voices.end(),[](const Voice& a, const Voice& b){return a.gain < b.gain;});
+    }
+    if(next->track != track)
+    {
+        next->track = track;
+        next->gain  = 0.f;
+        sources[static_cast<std::size_t>(track)]->rewind();
+    }
+    next->step = fade_step;
+}
+
+void MusicStream::mixBlock(std::size_t frames)
+{
+    std::fill(mixed.begin(),mixed.begin() + frames*music_channels,0);
+    for(Voice& voice : voices)
+    {
+        if(voice.track == MusicTrack::None){continue;}
+        MusicSource& source = *sources[static_cast<std::size_t>(voice.track)];
+        const auto channels = source.getChannelCount();
+        const auto count    = frames*channels;
+        std::size_t ready   = 0;
+        //tracks are looped, track that stays empty after rewind gives silence
+        bool rewound        = false;
+        while(ready < count)
+        {
+            const auto samples = source.read(decoded.data() + ready,count - ready);
+            if(samples == 0)
+            {
+                if(rewound){break;}
+                source.rewind();
+                rewound = true;
+                continue;
+            }
+            rewound = false;
+            ready  += samples;
+        }
+        std::fill(decoded.begin() + ready,decoded.begin() + count,std::int16_t(0));
+        for(std::size_t frame = 0; frame < frames; ++frame)
+        {
+            voice.gain = std::clamp(voice.gain + voice.step,0.f,1.f);
+            const auto left  = decoded[frame*channels];
+            const auto right = decoded[frame*channels + channels - 1];
+            mixed[frame*music_channels]     += static_cast<std::int32_t>(static_cast<float>(left)*voice.gain);
+            mixed[frame*music_channels + 1] += static_cast<std::int32_t>(static_cast<float>(right)*voice.gain);
+        }
+        if((voice.step < 0.f) && (voice.gain == 0.f)){voice.track = MusicTrack::None;}
+    }
+    for(std::size_t i = 0; i < frames*music_channels; ++i)
+    {
+        block[i] = static_cast<std::int16_t>(std::clamp(mixed[i],std::int32_t(-32768),std::int32_t(32767)));
+    }
+}
+
+MusicOutput::MusicOutput(MusicStream& stream):
+                stream(stream),
+                chunk(std::max<std::size_t>(static_cast<std::size_t>(music_chunk_s*static_cast<float>(stream.getSampleRate())),1)*music_channels)
+{
+    initialize(music_channels,stream.getSampleRate());
+}
+
+MusicOutput::~MusicOutput()
+{
+    //audio thread shall not call onGetData of destroyed object
+    stop();
+}
+
+bool MusicOutput::onGetData(Chunk& data)
+{
+    stream.read(chunk.data(),chunk.size());
+    data.samples     = chunk.data();
+    data.sampleCount = chunk.size();
+    return true;
+}
+
+void NullMusicOutput::consume(float seconds)
+{
+    const float frames = seconds*static_cast<float>(stream.getSampleRate()) + remainder;
+    const auto whole   = static_cast<std::size_t>(frames);
+    remainder          = frames - static_cast<float>(whole);
+    auto samples       = whole*music_channels;
+    consumed          += samples;
+    while(samples > 0)
+    {
+        const auto count = std::min(samples,chunk.size());
+        stream.read(chunk.data(),count);
+        samples -= count;
+    }
+}
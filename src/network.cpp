@@ -0,0 +1,447 @@
+/**
+ * @file network.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "alloc.hpp"
+#include "headless.hpp"
+#include "network.hpp"
+#include "pacer.hpp"
+
+using namespace si;
+
+//upper limit of space key presses applied from one input message
+constexpr std::uint32_t max_presses_per_input = 8;
+
+static std::int16_t quantize(float value)
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value*position_scale,-32768.f,32767.f)));
+}
+
+static EntityState makeEntityState(const Object& object)
+{
+    EntityState state;
+    const auto& position = object.getPosition();
+    state.x       = quantize(position.x);
+    state.y       = quantize(position.y);
+    state.visible = object.isVisible();
+    return state;
+}
+
+static void applyEntityState(const EntityState& state, Object& object)
+{
+    object.setPosition(sf::Vector2f(state.x/position_scale,state.y/position_scale));
+    object.setVisibility(state.visible);
+}
+
+Snapshot& SnapshotHistory::insert(std::uint32_t id)
+{
+    Snapshot& snapshot = ring[id % snapshot_history_size];
+    snapshot.id = id;
+    return snapshot;
+}
+
+const Snapshot* SnapshotHistory::find(std::uint32_t id) const
+{
+    const Snapshot& snapshot = ring[id % snapshot_history_size];
+    return ((id != 0) && (snapshot.id == id)) ? &snapshot : nullptr;
+}
+
+void si::captureSnapshot(const Game& game, Snapshot& snapshot)
+{
+    snapshot.status       = static_cast<std::uint8_t>(game.status);
+    snapshot.score        = game.elements.score;
+    snapshot.player_lives = game.elements.player_lives;
+    snapshot.entities.clear();
+    snapshot.entities.push_back(makeEntityState(*game.player));
+    snapshot.entities.push_back(makeEntityState(*game.invader_ship));
+    for(const Invader& enemy : game.enemies){snapshot.entities.push_back(makeEntityState(enemy));}
+    for(const Obstacle& obstacle : game.obstacles){snapshot.entities.push_back(makeEntityState(obstacle));}
+    for(const Shell& shell : game.bullets){snapshot.entities.push_back(makeEntityState(shell));}
+}
+
+void si::applySnapshot(const Snapshot& snapshot, Game& game)
+{
+    //client does not run simulation, events for presentation are derived from state changes
+    if(game.elements.score != snapshot.score){game.events.push(GameEvent{GameEventType::ScoreChanged,snapshot.score});}
+    if(game.elements.player_lives != snapshot.player_lives)
+    {
+        if(snapshot.player_lives < game.elements.player_lives)
+        {
+            game.events.push(GameEvent{GameEventType::LifeLost,snapshot.player_lives});
+        }
+        game.events.push(GameEvent{GameEventType::LivesChanged,snapshot.player_lives});
+    }
+    if((game.status != GameStatus::GameOver) && (snapshot.status == static_cast<std::uint8_t>(GameStatus::GameOver)))
+    {
+        game.events.push(GameEvent{GameEventType::GameOver,0});
+    }
+    game.status              = static_cast<GameStatus>(snapshot.status);
+    game.elements.score        = snapshot.score;
+    game.elements.player_lives = snapshot.player_lives;
+
+    const std::size_t fixed_items = 2 + game.enemies.size() + game.obstacles.size();
+    if(snapshot.entities.size() < fixed_items){return;}
+    auto state = snapshot.entities.begin();
+    applyEntityState(*state++,*game.player);
+    applyEntityState(*state++,*game.invader_ship);
+    for(Invader& enemy : game.enemies){applyEntityState(*state++,enemy);}
+    for(Obstacle& obstacle : game.obstacles){applyEntityState(*state++,obstacle);}
+    //server may have more shells than client, new ones are copied from the first one with texture
+    const std::size_t shells = snapshot.entities.size() - fixed_items;
+    while(game.bullets.size() < shells){game.bullets.push_back(game.bullets[0]);}
+    for(Shell& shell : game.bullets)
+    {
+        if(state != snapshot.entities.end()){applyEntityState(*state++,shell);}
+        else{shell.setVisibility(false);}
+    }
+    game.rebuildLiveLists();
+}
+
+void si::encodeSnapshot(const Snapshot& snapshot, const Snapshot* baseline, sf::Packet& packet)
+{
+    // message layout:
+    // header | change mask, one bit per entity | records of changed entities
+    // record: flags (bit 0 - visible, bit 1 - position follows) | x | y
+    const EntityState hidden;
+    const auto count = static_cast<std::uint16_t>(snapshot.entities.size());
+    auto base_state  = [&](std::size_t i) -> const EntityState&
+    {
+        return (baseline && (i < baseline->entities.size())) ? baseline->entities[i] : hidden;
+    };
+    auto position_changed = [](const EntityState& actual, const EntityState& base)
+    {
+        //invisible entity position is never sent, so it shall be sent again when entity appears
+        return actual.visible && (!base.visible || (actual.x != base.x) || (actual.y != base.y));
+    };
+    auto changed = [&](std::size_t i)
+    {
+        const EntityState& actual = snapshot.entities[i];
+        const EntityState& base   = base_state(i);
+        return (actual.visible != base.visible) || position_changed(actual,base);
+    };
+
+    packet<<static_cast<std::uint8_t>(MessageType::Snapshot)<<snapshot.id<<(baseline ? baseline->id : 0u);
+    packet<<snapshot.status<<snapshot.score<<snapshot.player_lives<<count;
+    for(std::size_t i = 0; i < count; i += 8)
+    {
+        std::uint8_t mask = 0;
+        for(std::size_t bit = 0; (bit < 8) && (i + bit < count); ++bit)
+        {
+            if(changed(i + bit)){mask |= static_cast<std::uint8_t>(1u << bit);}
+        }
+        packet<<mask;
+    }
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(!changed(i)){continue;}
+        const EntityState& actual = snapshot.entities[i];
+        const bool send_position  = position_changed(actual,base_state(i));
+        packet<<static_cast<std::uint8_t>((actual.visible ? 1u : 0u) | (send_position ? 2u : 0u));
+        if(send_position){packet<<actual.x<<actual.y;}
+    }
+}
+
+bool si::decodeSnapshot(sf::Packet& packet, const SnapshotHistory& history, Snapshot& snapshot)
+{
+    std::uint32_t baseline_id = 0;
+    std::uint16_t count       = 0;
+    packet>>snapshot.id>>baseline_id>>snapshot.status>>snapshot.score>>snapshot.player_lives>>count;
+    if(!packet){return false;}
+    const Snapshot* baseline = nullptr;
+    if(baseline_id != 0)
+    {
+        baseline = history.find(baseline_id);
+        if(baseline == nullptr){return false;}
+    }
+    snapshot.entities.assign(count,EntityState());
+    if(baseline)
+    {
+        const auto common = std::min(snapshot.entities.size(),baseline->entities.size());
+        std::copy_n(baseline->entities.begin(),common,snapshot.entities.begin());
+    }
+    //masks are read first, records follow in the same order
+    std::vector<std::uint8_t> masks((count + 7)/8);
+    for(std::uint8_t& mask : masks){packet>>mask;}
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if((masks[i/8] & (1u << (i % 8))) == 0){continue;}
+        std::uint8_t flags = 0;
+        packet>>flags;
+        snapshot.entities[i].visible = (flags & 1u) != 0;
+        if(flags & 2u){packet>>snapshot.entities[i].x>>snapshot.entities[i].y;}
+    }
+    return static_cast<bool>(packet);
+}
+
+Server::Server(unsigned short port): tickrate(Game::tickrate)
+{
+    if(socket.bind(port) != sf::Socket::Done)
+    {
+        throw std::runtime_error(std::string("Could not bind server port!"));
+    }
+    socket.setBlocking(false);
+    setupHeadlessItems(game);
+}
+
+void Server::run(std::uint64_t ticks)
+{
+    //server does not need precise ticks, spin-wait is not used
+    FramePacer pacer(tickrate,true);
+    const std::uint64_t stats_period = static_cast<std::uint64_t>(tickrate)*server_stats_period_s;
+    std::uint64_t stats_ticks        = 0;
+    clock::duration simulation_time  = clock::duration::zero();
+
+    std::cout<<"server is running on port "<<socket.getLocalPort()<<"\n";
+    for(std::uint64_t tick = 0; (ticks == 0) || (tick < ticks); ++tick)
+    {
+        const auto start = clock::now();
+        {
+            AllocationScope scope(AllocationStage::Network);
+            receiveInputs();
+            dropSilentClients();
+        }
+        if(game.status == GameStatus::Running){game.gameLoop();}
+        //clients derive presentation events from snapshots
+        game.events.drain([](const GameEvent&){});
+        simulation_time += clock::now() - start;
+        {
+            AllocationScope scope(AllocationStage::Network);
+            broadcastSnapshot();
+        }
+        game.arena.reset();
+        if((++stats_ticks == stats_period) || (tick + 1 == ticks))
+        {
+            printStatistics(stats_ticks,simulation_time);
+            stats_ticks     = 0;
+            simulation_time = clock::duration::zero();
+        }
+        pacer.waitForNextFrame();
+    }
+}
+
+void Server::receiveInputs()
+{
+    sf::IpAddress address;
+    unsigned short port;
+    while(socket.receive(packet,address,port) == sf::Socket::Done)
+    {
+        std::uint8_t type = 0;
+        std::uint8_t keys = 0;
+        ClientInput input;
+        packet>>type>>input.acked_snapshot>>keys>>input.space_presses;
+        if(!packet || (type != static_cast<std::uint8_t>(MessageType::Input))){continue;}
+        input.left       = (keys & 1u) != 0;
+        input.right      = (keys & 2u) != 0;
+        input.disconnect = (keys & 4u) != 0;
+
+        auto it = std::find_if(clients.begin(),clients.end(),[&](const RemoteClient& client)
+        {
+            return (client.address == address) && (client.port == port);
+        });
+        if(it == clients.end())
+        {
+            if(input.disconnect){continue;}
+            RemoteClient client;
+            client.address = address;
+            client.port    = port;
+            clients.push_back(client);
+            it = clients.end() - 1;
+            std::cout<<"client "<<address.toString()<<":"<<port<<" connected\n";
+        }
+        const auto index = static_cast<std::size_t>(it - clients.begin());
+        if(input.disconnect)
+        {
+            removeClient(index);
+            continue;
+        }
+        //datagrams may be reordered, counters never go back
+        input.acked_snapshot = std::max(input.acked_snapshot,it->input.acked_snapshot);
+        input.space_presses  = std::max(input.space_presses,it->input.space_presses);
+        if(index == 0){applyInput(it->input,input);}
+        it->input     = input;
+        it->last_seen = clock::now();
+    }
+}
+
+void Server::applyInput(const ClientInput& previous, const ClientInput& actual)
+{
+    //remote input goes through the same path as window events
+    auto key_event = [this](sf::Keyboard::Key key, bool pressed)
+    {
+        sf::Event event{};
+        event.type     = pressed ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+        event.key.code = key;
+        game.executeEvent(event);
+    };
+
+    if(previous.left != actual.left){key_event(sf::Keyboard::Key::Left,actual.left);}
+    if(previous.right != actual.right){key_event(sf::Keyboard::Key::Right,actual.right);}
+    const auto presses = std::min(actual.space_presses - previous.space_presses,max_presses_per_input);
+    for(std::uint32_t i = 0; i < presses; ++i)
+    {
+        key_event(sf::Keyboard::Key::Space,true);
+        key_event(sf::Keyboard::Key::Space,false);
+    }
+}
+
+void Server::removeClient(std::size_t index)
+{
+    std::cout<<"client "<<clients[index].address.toString()<<":"<<clients[index].port<<" disconnected\n";
+    if(index == 0)
+    {
+        //release keys of leaving player and press keys of the next one
+        ClientInput released = clients[0].input;
+        released.left  = false;
+        released.right = false;
+        applyInput(clients[0].input,released);
+        if(clients.size() > 1)
+        {
+            ClientInput next = clients[1].input;
+            next.left  = false;
+            next.right = false;
+            applyInput(next,clients[1].input);
+        }
+    }
+    clients.erase(clients.begin() + index);
+}
+
+void Server::dropSilentClients()
+{
+    const auto now = clock::now();
+    for(std::size_t i = clients.size(); i > 0; --i)
+    {
+        if(now - clients[i - 1].last_seen > std::chrono::seconds(client_timeout_s)){removeClient(i - 1);}
+    }
+}
+
+void Server::broadcastSnapshot()
+{
+    Snapshot& snapshot = history.insert(++snapshot_id);
+    captureSnapshot(game,snapshot);
+    for(RemoteClient& client : clients)
+    {
+        const auto start = clock::now();
+        packet.clear();
+        const Snapshot* baseline = history.find(client.input.acked_snapshot);
+        encodeSnapshot(snapshot,baseline,packet);
+        socket.send(packet,client.address,client.port);
+        client.bytes_sent += packet.getDataSize();
+        ++client.snapshots;
+        if(baseline){++client.delta_snapshots;}
+        client.cpu_time   += clock::now() - start;
+    }
+}
+
+void Server::printStatistics(std::uint64_t ticks, clock::duration simulation_time)
+{
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+    if(ticks == 0){return;}
+    std::uint64_t bytes = 0;
+    clock::duration clients_time = clock::duration::zero();
+    statistics = ServerStatistics();
+    for(RemoteClient& client : clients)
+    {
+        bytes                      += client.bytes_sent;
+        clients_time               += client.cpu_time;
+        statistics.snapshots       += client.snapshots;
+        statistics.delta_snapshots += client.delta_snapshots;
+        client.bytes_sent      = 0;
+        client.snapshots       = 0;
+        client.delta_snapshots = 0;
+        client.cpu_time        = clock::duration::zero();
+    }
+    const auto num_of_clients        = std::max<std::size_t>(clients.size(),1);
+    statistics.clients               = clients.size();
+    statistics.bytes_per_tick        = bytes/ticks;
+    statistics.bytes_per_tick_client = bytes/ticks/num_of_clients;
+    std::cout<<"server: clients "<<statistics.clients
+             <<", bytes/tick "<<statistics.bytes_per_tick
+             <<", bytes/tick/client "<<statistics.bytes_per_tick_client
+             <<", delta snapshots "<<statistics.delta_snapshots<<"/"<<statistics.snapshots
+             <<", simulation us/tick "<<duration_cast<microseconds>(simulation_time).count()/static_cast<long long>(ticks)
+             <<", us/tick/client "<<duration_cast<microseconds>(clients_time).count()/static_cast<long long>(ticks*num_of_clients)
+             <<"\n";
+}
+
+Client::Client(const sf::IpAddress& address, unsigned short port):
+                server_address(address),
+                server_port(port)
+{
+    if(socket.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+    {
+        throw std::runtime_error(std::string("Could not bind client port!"));
+    }
+    socket.setBlocking(false);
+}
+
+Client::~Client()
+{
+    input.disconnect = true;
+    sendInput();
+}
+
+void Client::handleEvent(const sf::Event& event)
+{
+    const bool pressed = (event.type == sf::Event::KeyPressed);
+    if(!pressed && (event.type != sf::Event::KeyReleased)){return;}
+    switch(event.key.code)
+    {
+        case sf::Keyboard::Key::Left:
+            input.left = pressed;
+            break;
+
+        case sf::Keyboard::Key::Right:
+            input.right = pressed;
+            break;
+
+        case sf::Keyboard::Key::Space:
+            if(pressed){++input.space_presses;}
+            break;
+
+        default:
+            break;
+    }
+}
+
+void Client::update(Game& game)
+{
+    sendInput();
+    sf::IpAddress address;
+    unsigned short port;
+    const Snapshot* newest = nullptr;
+    while(socket.receive(packet,address,port) == sf::Socket::Done)
+    {
+        std::uint8_t type = 0;
+        packet>>type;
+        if((address != server_address) || (type != static_cast<std::uint8_t>(MessageType::Snapshot))){continue;}
+        //snapshots older than acknowledged one are useless
+        if(decodeSnapshot(packet,history,received) && (received.id > input.acked_snapshot))
+        {
+            Snapshot& slot = history.insert(received.id);
+            slot.status       = received.status;
+            slot.score        = received.score;
+            slot.player_lives = received.player_lives;
+            slot.entities     = received.entities;
+            input.acked_snapshot = received.id;
+            newest = &slot;
+        }
+    }
+    if(newest){applySnapshot(*newest,game);}
+}
+
+void Client::sendInput()
+{
+    const std::uint8_t keys = (input.left ? 1u : 0u) | (input.right ? 2u : 0u) | (input.disconnect ? 4u : 0u);
+    packet.clear();
+    packet<<static_cast<std::uint8_t>(MessageType::Input)<<input.acked_snapshot<<keys<<input.space_presses;
+    socket.send(packet,server_address,server_port);
+}
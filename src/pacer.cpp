@@ -0,0 +1,78 @@
+/**
+ * @file pacer.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <thread>
+#include <algorithm>
+#include "pacer.hpp"
+
+using namespace std::chrono;
+
+FramePacer::FramePacer(const unsigned int framerate, bool power_saving):
+                period(duration_cast<clock::duration>(seconds(1)) / std::max(framerate,1u)),
+                overshoot(microseconds(1000)),
+                power_saving(power_saving)
+{
+}
+
+void FramePacer::waitForNextFrame()
+{
+    auto now = clock::now();
+    if(!started)
+    {
+        started    = true;
+        deadline   = now + period;
+        last_frame = now;
+        return;
+    }
+    //we are late for more than one period, do not try to catch up
+    if(now > deadline + period){deadline = now;}
+
+    if(power_saving)
+    {
+        if(now < deadline){coarseSleep(deadline);}
+    }
+    else
+    {
+        //sleep as long as OS allows, the rest of period is spent in spin-wait
+        const auto wake_up = deadline - overshoot - microseconds(spin_margin_us);
+        if(now < wake_up){coarseSleep(wake_up);}
+        while(clock::now() < deadline){}
+    }
+    now = clock::now();
+    recordFrame(now - last_frame);
+    last_frame = now;
+    deadline  += period;
+}
+
+void FramePacer::printStatistics(std::ostream& stream) const
+{
+    stream<<"frame jitter histogram ("<<histogram.frames<<" frames, max "<<histogram.max_jitter_us<<" us):\n";
+    for(auto i = 0; i < jitter_histogram_bins; ++i)
+    {
+        if(histogram.bins[i] == 0){continue;}
+        stream<<"  "<<i*jitter_bin_width_us<<((i == jitter_histogram_bins - 1) ? "+ us" : " us")<<" : "<<histogram.bins[i]<<"\n";
+    }
+}
+
+void FramePacer::coarseSleep(clock::time_point wake_up)
+{
+    std::this_thread::sleep_until(wake_up);
+    const auto late = clock::now() - wake_up;
+    //grow fast when OS wakes us later than expected, shrink slowly otherwise
+    if(late > overshoot){overshoot = (overshoot + late)/2;}
+    else{overshoot = (overshoot*7 + late)/8;}
+}
+
+void FramePacer::recordFrame(clock::duration frame_time)
+{
+    const auto jitter_us = duration_cast<microseconds>(frame_time > period ? frame_time - period : period - frame_time).count();
+    const auto bin       = std::min<long long>(jitter_us/jitter_bin_width_us, jitter_histogram_bins - 1);
+    ++histogram.bins[bin];
+    ++histogram.frames;
+    histogram.max_jitter_us = std::max(histogram.max_jitter_us,static_cast<long long>(jitter_us));
+}
@@ -0,0 +1,136 @@
+/**
+ * @file particles.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include "particles.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PARTICLES_SSE2
+#endif
+
+using namespace si;
+
+//number of particles processed by one simd instruction
+constexpr std::size_t simd_width = 4;
+
+ParticleSystem::ParticleSystem(std::size_t capacity):
+                capacity((capacity + simd_width - 1)/simd_width*simd_width),
+                x(this->capacity),
+                y(this->capacity),
+                vx(this->capacity),
+                vy(this->capacity),
+                life(this->capacity),
+                inv_life(this->capacity),
+                colors(this->capacity),
+                vertices(this->capacity*4)
+{
+}
+
+void ParticleSystem::emit(const sf::Vector2f& position, std::size_t count, const sf::Color& color)
+{
+    constexpr float pi = 3.14159265f;
+    std::uniform_real_distribution<float> angle(0.f,2.f*pi);
+    std::uniform_real_distribution<float> speed(particle_min_speed,particle_max_speed);
+    std::uniform_real_distribution<float> lifetime(particle_min_life,particle_max_life);
+    count = static_cast<std::size_t>(static_cast<float>(count)*density);
+    for(std::size_t i = 0; (i < count) && (size < capacity); ++i, ++size)
+    {
+        const float direction = angle(randomizer);
+        const float velocity  = speed(randomizer);
+        x[size]        = position.x;
+        y[size]        = position.y;
+        vx[size]       = std::cos(direction)*velocity;
+        vy[size]       = std::sin(direction)*velocity;
+        life[size]     = lifetime(randomizer);
+        inv_life[size] = 1.f/life[size];
+        colors[size]   = color;
+    }
+}
+
+void ParticleSystem::update(float dt)
+{
+    integrate(dt);
+    compact();
+    buildVertices();
+}
+
+void ParticleSystem::integrate(float dt)
+{
+    //tail up to simd width is processed too, capacity is padded for it
+    const std::size_t count = (size + simd_width - 1)/simd_width*simd_width;
+    float* px = x.data();
+    float* py = y.data();
+    float* pvx = vx.data();
+    float* pvy = vy.data();
+    float* plife = life.data();
+#ifdef PARTICLES_SSE2
+    const __m128 step    = _mm_set1_ps(dt);
+    const __m128 gravity = _mm_set1_ps(particle_gravity*dt);
+    for(std::size_t i = 0; i < count; i += simd_width)
+    {
+        const __m128 velocity_x = _mm_loadu_ps(pvx + i);
+        const __m128 velocity_y = _mm_add_ps(_mm_loadu_ps(pvy + i),gravity);
+        _mm_storeu_ps(px + i,_mm_add_ps(_mm_loadu_ps(px + i),_mm_mul_ps(velocity_x,step)));
+        _mm_storeu_ps(py + i,_mm_add_ps(_mm_loadu_ps(py + i),_mm_mul_ps(velocity_y,step)));
+        _mm_storeu_ps(pvy + i,velocity_y);
+        _mm_storeu_ps(plife + i,_mm_sub_ps(_mm_loadu_ps(plife + i),step));
+    }
+#else
+    const float gravity = particle_gravity*dt;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        pvy[i]   += gravity;
+        px[i]    += pvx[i]*dt;
+        py[i]    += pvy[i]*dt;
+        plife[i] -= dt;
+    }
+#endif
+}
+
+void ParticleSystem::compact()
+{
+    std::size_t i = 0;
+    while(i < size)
+    {
+        if(life[i] > 0.f){++i;continue;}
+        //move last live particle in place of dead one
+        --size;
+        x[i]        = x[size];
+        y[i]        = y[size];
+        vx[i]       = vx[size];
+        vy[i]       = vy[size];
+        life[i]     = life[size];
+        inv_life[i] = inv_life[size];
+        colors[i]   = colors[size];
+    }
+}
+
+void ParticleSystem::buildVertices()
+{
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        sf::Color color = colors[i];
+        color.a = static_cast<sf::Uint8>(255.f*std::min(life[i]*inv_life[i],1.f));
+        sf::Vertex* quad = &vertices[i*4];
+        quad[0].position = sf::Vector2f(x[i],y[i]);
+        quad[1].position = sf::Vector2f(x[i] + particle_size,y[i]);
+        quad[2].position = sf::Vector2f(x[i] + particle_size,y[i] + particle_size);
+        quad[3].position = sf::Vector2f(x[i],y[i] + particle_size);
+        quad[0].color = color;
+        quad[1].color = color;
+        quad[2].color = color;
+        quad[3].color = color;
+    }
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if(size > 0){target.draw(vertices.data(),size*4,sf::Quads,states);}
+}
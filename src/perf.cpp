@@ -0,0 +1,183 @@
+/**
+ * @file perf.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include "perf.hpp"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace si;
+
+static const std::array<const char*,static_cast<std::size_t>(PerfStage::Count)> stage_names = 
+{
+    "collision",
+    "items update",
+    "canvas update"
+};
+
+static const std::array<const char*,static_cast<std::size_t>(PerfCounter::Count)> counter_names = 
+{
+    "cycles",
+    "instructions",
+    "cache misses",
+    "branch misses"
+};
+
+#ifdef __linux__
+
+//hardware events in order of PerfCounter
+static const std::array<std::uint64_t,static_cast<std::size_t>(PerfCounter::Count)> hardware_events = 
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/// @brief open one counter of the calling thread in user space
+static int openCounter(std::uint64_t event, int group)
+{
+    perf_event_attr attributes;
+    std::memset(&attributes,0,sizeof(attributes));
+    attributes.size           = sizeof(attributes);
+    attributes.type           = PERF_TYPE_HARDWARE;
+    attributes.config         = event;
+    attributes.disabled       = (group == -1) ? 1 : 0;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+    attributes.read_format    = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(__NR_perf_event_open,&attributes,0,-1,group,0));
+}
+
+PerfCounters::PerfCounters()
+{
+    descriptors.fill(-1);
+    positions.fill(-1);
+    //cycles counter leads the group, other counters are optional, virtual machines often lack them
+    for(std::size_t i = 0; i < num_of_counters; ++i)
+    {
+        descriptors[i] = openCounter(hardware_events[i],leader);
+        if(descriptors[i] < 0)
+        {
+            if(i == 0){return;}
+            continue;
+        }
+        if(i == 0){leader = descriptors[0];}
+        positions[i] = static_cast<int>(opened++);
+    }
+    ioctl(leader,PERF_EVENT_IOC_RESET,PERF_IOC_FLAG_GROUP);
+    ioctl(leader,PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters()
+{
+    for(int descriptor : descriptors)
+    {
+        if(descriptor >= 0){close(descriptor);}
+    }
+}
+
+bool PerfCounters::read(std::array<std::uint64_t,num_of_counters>& values) const
+{
+    //group read format: number of counters, then values in order of opening
+    std::array<std::uint64_t,num_of_counters + 1> buffer{};
+    const auto size = static_cast<ssize_t>((opened + 1)*sizeof(std::uint64_t));
+    if(::read(leader,buffer.data(),static_cast<std::size_t>(size)) != size){return false;}
+    for(std::size_t i = 0; i < num_of_counters; ++i)
+    {
+        values[i] = (positions[i] >= 0) ? buffer[static_cast<std::size_t>(positions[i]) + 1] : 0;
+    }
+    return true;
+}
+
+#else
+
+PerfCounters::PerfCounters()
+{
+    descriptors.fill(-1);
+    positions.fill(-1);
+}
+
+PerfCounters::~PerfCounters()
+{
+}
+
+bool PerfCounters::read(std::array<std::uint64_t,num_of_counters>&) const
+{
+    return false;
+}
+
+#endif //__linux__
+
+void PerfCounters::begin()
+{
+    skip_run = false;
+    if(isAvailable()){read(start);}
+}
+
+void PerfCounters::end(PerfStage stage)
+{
+    std::array<std::uint64_t,num_of_counters> values;
+    PerfStageTotals& stage_totals = totals[static_cast<std::size_t>(stage)];
+    if(skip_run)
+    {
+        ++stage_totals.skipped;
+        return;
+    }
+    if(!isAvailable() || !read(values)){return;}
+    ++stage_totals.samples;
+    for(std::size_t i = 0; i < num_of_counters; ++i)
+    {
+        const auto delta      = values[i] - start[i];
+        stage_totals.sum[i]  += delta;
+        stage_totals.max[i]   = std::max(stage_totals.max[i],delta);
+    }
+}
+
+void PerfCounters::print(std::ostream& stream) const
+{
+    if(!isAvailable())
+    {
+        stream<<"perf counters: not available\n";
+        return;
+    }
+    //counters are opened for the game thread only, runs with pool work are skipped
+    stream<<"perf counters of game thread (average / max per run):\n";
+    for(std::size_t stage = 0; stage < totals.size(); ++stage)
+    {
+        const PerfStageTotals& stage_totals = totals[stage];
+        if((stage_totals.samples == 0) && (stage_totals.skipped == 0)){continue;}
+        stream<<"  "<<stage_names[stage]<<" ("<<stage_totals.samples<<" runs";
+        if(stage_totals.skipped != 0){stream<<", "<<stage_totals.skipped<<" runs on thread pool not measured";}
+        stream<<"):";
+        if(stage_totals.samples == 0)
+        {
+            stream<<" n/a\n";
+            continue;
+        }
+        for(std::size_t i = 0; i < num_of_counters; ++i)
+        {
+            stream<<(i == 0 ? " " : ", ")<<counter_names[i]<<" ";
+            if(positions[i] < 0){stream<<"n/a";}
+            else{stream<<stage_totals.sum[i]/stage_totals.samples<<" / "<<stage_totals.max[i];}
+        }
+        const auto cycles       = stage_totals.sum[static_cast<std::size_t>(PerfCounter::Cycles)];
+        const auto instructions = stage_totals.sum[static_cast<std::size_t>(PerfCounter::Instructions)];
+        if((cycles != 0) && (positions[static_cast<std::size_t>(PerfCounter::Instructions)] >= 0))
+        {
+            stream<<", IPC "<<static_cast<double>(instructions)/static_cast<double>(cycles);
+        }
+        stream<<"\n";
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file pool.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include "pool.hpp"
+
+using namespace si;
+
+ThreadPool::ThreadPool(std::size_t num_of_threads):
+                slices(new Slice[num_of_threads + 1])
+{
+    for(std::size_t i = 0; i < num_of_threads; ++i)
+    {
+        threads.emplace_back([this, i]{workerLoop(i + 1);});
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    start_signal.notify_all();
+    for(std::thread& thread : threads){thread.join();}
+}
+
+std::size_t ThreadPool::defaultThreads()
+{
+    const std::size_t hardware = std::thread::hardware_concurrency();
+    return (hardware > 1) ? hardware - 1 : 0;
+}
+
+void ThreadPool::run(std::size_t count, std::size_t grain, Invoker invoker, void* context)
+{
+    const auto workers = getWorkers();
+    const auto step    = (count + workers - 1)/workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(std::size_t i = 0; i < workers; ++i)
+        {
+            slices[i].next.store(std::min(i*step,count),std::memory_order_relaxed);
+            slices[i].end = std::min((i + 1)*step,count);
+        }
+        this->invoker = invoker;
+        this->context = context;
+        this->grain   = std::max<std::size_t>(grain,1);
+        running       = threads.size();
+        ++generation;
+    }
+    start_signal.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done_signal.wait(lock,[this]{return running == 0;});
+}
+
+void ThreadPool::work(std::size_t worker)
+{
+    const auto workers = getWorkers();
+    for(std::size_t k = 0; k < workers; ++k)
+    {
+        //own slice first, then neighbours
+        Slice& slice = slices[(worker + k) % workers];
+        for(;;)
+        {
+            const auto first = slice.next.fetch_add(grain,std::memory_order_relaxed);
+            if(first >= slice.end){break;}
+            invoker(context,worker,first,std::min(first + grain,slice.end));
+        }
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t worker)
+{
+    std::uint64_t seen = 0;
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_signal.wait(lock,[&]{return stop || (generation != seen);});
+            if(stop){return;}
+            seen = generation;
+        }
+        work(worker);
+        std::lock_guard<std::mutex> lock(mutex);
+        if(--running == 0){done_signal.notify_one();}
+    }
+}
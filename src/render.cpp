@@ -0,0 +1,100 @@
+/**
+ * @file render.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include "render.hpp"
+
+using namespace si;
+
+void RenderQueue::add(RenderLayer layer, const Object& object)
+{
+    add(layer,object.getSprite());
+}
+
+void RenderQueue::add(RenderLayer layer, const sf::Sprite& sprite)
+{
+    commands.push_back(RenderCommand{layer,sprite.getTexture(),sprite.getTextureRect(),sprite.getTransform(),
+                                     sprite.getColor(),nullptr,static_cast<std::uint32_t>(commands.size())});
+}
+
+void RenderQueue::add(RenderLayer layer, const sf::Drawable& drawable)
+{
+    commands.push_back(RenderCommand{layer,nullptr,sf::IntRect(),sf::Transform(),
+                                     sf::Color::White,&drawable,static_cast<std::uint32_t>(commands.size())});
+}
+
+void RenderQueue::sort()
+{
+    //sequence makes the key unique, so std::sort gives stable result without extra buffer
+    std::sort(commands.begin(),commands.end(),[](const RenderCommand& a, const RenderCommand& b)
+    {
+        if(a.layer != b.layer){return a.layer < b.layer;}
+        if(a.texture != b.texture){return std::less<const sf::Texture*>()(a.texture,b.texture);}
+        return a.sequence < b.sequence;
+    });
+}
+
+void RenderBackend::submit(const RenderQueue& queue)
+{
+    statistics = RenderStatistics();
+    batch.clear();
+    batch_texture = nullptr;
+    beginFrame(queue);
+    bool first_texture = true;
+    for(const RenderCommand& command : queue.getCommands())
+    {
+        ++statistics.commands;
+        if(command.drawable)
+        {
+            flush();
+            drawItem(*command.drawable);
+            ++statistics.draw_calls;
+            continue;
+        }
+        if((command.texture != batch_texture) || first_texture)
+        {
+            flush();
+            if(!first_texture){++statistics.texture_changes;}
+            first_texture = false;
+            batch_texture = command.texture;
+        }
+        //quad corners in the same order as sf::Sprite
+        const sf::IntRect& rectangle = command.rectangle;
+        const float width  = static_cast<float>(std::abs(rectangle.width));
+        const float height = static_cast<float>(std::abs(rectangle.height));
+        const float left   = static_cast<float>(rectangle.left);
+        const float top    = static_cast<float>(rectangle.top);
+        const float right  = left + static_cast<float>(rectangle.width);
+        const float bottom = top + static_cast<float>(rectangle.height);
+        batch.emplace_back(command.transform.transformPoint(0.f,0.f),command.color,sf::Vector2f(left,top));
+        batch.emplace_back(command.transform.transformPoint(width,0.f),command.color,sf::Vector2f(right,top));
+        batch.emplace_back(command.transform.transformPoint(width,height),command.color,sf::Vector2f(right,bottom));
+        batch.emplace_back(command.transform.transformPoint(0.f,height),command.color,sf::Vector2f(left,bottom));
+    }
+    flush();
+}
+
+void RenderBackend::flush()
+{
+    if(batch.empty()){return;}
+    drawQuads(batch.data(),batch.size(),batch_texture);
+    ++statistics.draw_calls;
+    batch.clear();
+}
+
+void SfmlBackend::drawQuads(const sf::Vertex* vertices, std::size_t count, const sf::Texture* texture)
+{
+    target.draw(vertices,count,sf::Quads,sf::RenderStates(texture));
+}
+
+void SfmlBackend::drawItem(const sf::Drawable& drawable)
+{
+    target.draw(drawable);
+}
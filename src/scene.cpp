@@ -0,0 +1,98 @@
+/**
+ * @file scene.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include "scene.hpp"
+
+using namespace si;
+
+//object rectangles for the menu frames
+static const std::array<sf::IntRect,num_of_frames> frame_rectangles = 
+{
+    sf::IntRect(0,0,si::default_x_size,si::frame_width),
+    sf::IntRect(0,0,si::frame_width,si::default_y_size),
+    sf::IntRect(0,0,si::default_x_size,si::frame_width),
+    sf::IntRect(0,0,si::frame_width,si::default_y_size),
+    sf::IntRect(0,0,si::default_x_size,si::frame_width)
+};
+//object positions for the menu frames
+static const std::array<sf::Vector2f,num_of_frames> frame_positions = 
+{
+    sf::Vector2f(si::default_start_x,si::default_start_y),
+    sf::Vector2f(si::default_x_size - static_cast<float>(si::frame_width),si::default_start_y),
+    sf::Vector2f(si::default_start_x,static_cast<float>(si::frame_length)),
+    sf::Vector2f(si::default_start_x,si::default_start_y),
+    sf::Vector2f(si::default_start_x,si::default_y_size - static_cast<float>(si::frame_width))
+};
+
+template<class GameType>
+void si::recordGameItems(RenderQueue& queue, const GameType& game)
+{
+    //update enemies 
+    for (std::uint32_t index : game.getLiveInvaders())
+    {
+        queue.add(RenderLayer::Items,game.enemies[index]);
+    }    
+    //update bullets
+    for (std::uint32_t index : game.getLiveShells())
+    {
+        queue.add(RenderLayer::Items,game.bullets[index]);
+    }
+    //update obstacles
+    for (std::uint32_t index : game.getLiveObstacles())
+    {
+        queue.add(RenderLayer::Items,game.obstacles[index]);
+    }
+    //update explosion debris, all particles in one draw call
+    queue.add(RenderLayer::Effects,game.particles);
+    //update enemy ship
+    if(game.invader_ship->isVisible()){queue.add(RenderLayer::Ships,*game.invader_ship);}
+    //update player ship
+    queue.add(RenderLayer::Ships,*game.player);
+}
+
+template void si::recordGameItems(RenderQueue& queue, const Game& game);
+template void si::recordGameItems(RenderQueue& queue, const StressGame& game);
+template void si::recordGameItems(RenderQueue& queue, const BenchmarkGame& game);
+
+void si::setupHud(HudSprites& hud, const sf::Font& font, unsigned int character_size, const sf::Texture& player, const sf::Texture& frame)
+{
+    //setup game score item
+    hud.score.setFont(font);
+    hud.score.setCharacterSize(character_size);
+    hud.score.setPosition(sf::Vector2f(static_cast<float>(si::frame_length),static_cast<float>(si::frame_width)));
+    //player lives indicator
+    hud.live.setTexture(player);
+    //setup canvas frames
+    for (Object& item: hud.frames)
+    {
+        auto i = &item - &hud.frames[0];
+        item.setSpriteRectangle(frame_rectangles[i]);
+        item.setTexture(frame);
+        item.setSpriteColor(sf::Color::White);
+        item.setPosition(frame_positions[i]);
+    }
+}
+
+void si::recordHud(RenderQueue& queue, HudSprites& hud, int lives)
+{
+    //update score indicator
+    queue.add(RenderLayer::Menu,hud.score);
+    //update lives indicator, small border prevents sprites from sticking together
+    constexpr float border = 10.f;
+    sf::IntRect texture_size = hud.live.getTextureRect();
+    //initial offset, lives will be drawn from right to left
+    float offset = si::default_x_size - si::frame_width - static_cast<float>(texture_size.width) - border;
+    for(auto i = 0; i < lives; i++)
+    {
+        hud.live.setPosition(sf::Vector2f(offset,static_cast<float>(si::frame_width)));
+        queue.add(RenderLayer::Menu,hud.live);
+        offset -= static_cast<float>(texture_size.width) + border;
+    }
+    //update menu frames
+    for(const Object& frame : hud.frames){queue.add(RenderLayer::Menu,frame);}
+}
@@ -0,0 +1,33 @@
+/**
+ * @file startup.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include "startup.hpp"
+
+using namespace std::chrono;
+
+void StartupTimeline::mark(const char* phase)
+{
+    const auto now = clock::now();
+    if(count < max_startup_phases)
+    {
+        names[count]     = phase;
+        durations[count] = now - last;
+        ++count;
+    }
+    last = now;
+}
+
+void StartupTimeline::print(std::ostream& stream) const
+{
+    stream<<"startup phases:\n";
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        stream<<"  "<<names[i]<<" : "<<duration_cast<microseconds>(durations[i]).count()<<" us\n";
+    }
+    stream<<"  total : "<<duration_cast<microseconds>(last - start).count()<<" us\n";
+}
@@ -0,0 +1,73 @@
+/**
+ * @file timers.cpp
+ *
+ * @brief 
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+#include "timers.hpp"
+
+using namespace si;
+
+TimerWheel::TimerWheel(std::size_t capacity): nodes(capacity)
+{
+    slots.fill(none);
+}
+
+void TimerWheel::schedule(std::uint32_t id, std::uint64_t delay)
+{
+    if(nodes[id].pending){unlink(id);}
+    nodes[id].expiry = now + ((delay != 0) ? delay : 1);
+    link(id);
+}
+
+void TimerWheel::cancel(std::uint32_t id)
+{
+    if(nodes[id].pending){unlink(id);}
+}
+
+void TimerWheel::cancelAll()
+{
+    for(std::uint32_t id = 0; id < nodes.size(); ++id){cancel(id);}
+}
+
+void TimerWheel::link(std::uint32_t id)
+{
+    Node& node = nodes[id];
+    const auto delta = node.expiry - now;
+    //the lowest level which range covers the delay, far timers stay on the top level
+    //and are moved down again when their slot is due
+    std::size_t level = 0;
+    while((level + 1 < timer_wheel_levels) && (delta >= (std::uint64_t(1) << (timer_slot_bits*(level + 1))))){++level;}
+    node.slot     = static_cast<std::uint32_t>(level*timer_wheel_slots + ((node.expiry >> (timer_slot_bits*level)) & slot_mask));
+    node.previous = none;
+    node.next     = slots[node.slot];
+    if(node.next != none){nodes[node.next].previous = id;}
+    slots[node.slot] = id;
+    node.pending     = true;
+}
+
+void TimerWheel::unlink(std::uint32_t id)
+{
+    Node& node = nodes[id];
+    if(node.previous != none){nodes[node.previous].next = node.next;}
+    else{slots[node.slot] = node.next;}
+    if(node.next != none){nodes[node.next].previous = node.previous;}
+    node.next     = none;
+    node.previous = none;
+    node.pending  = false;
+}
+
+void TimerWheel::cascade(std::size_t level, std::size_t slot)
+{
+    //list is detached first, timers can be linked back to the same slot
+    auto id = slots[level*timer_wheel_slots + slot];
+    slots[level*timer_wheel_slots + slot] = none;
+    while(id != none)
+    {
+        const auto next = nodes[id].next;
+        link(id);
+        id = next;
+    }
+}
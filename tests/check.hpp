@@ -0,0 +1,27 @@
+/**
+ * @file check.hpp
+ *
+ * @brief minimal checks for test executables, failed check stops the test with non-zero exit code
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+
+/// @brief stop test if condition is false
+#define CHECK(condition)                                                                      \
+    do                                                                                        \
+    {                                                                                         \
+        if(!(condition))                                                                      \
+        {                                                                                     \
+            std::cerr<<__FILE__<<":"<<__LINE__<<": check failed: "<<#condition<<"\n";      \
+            std::exit(EXIT_FAILURE);                                                          \
+        }                                                                                     \
+    } while(false)
+
+#endif //CHECK_H
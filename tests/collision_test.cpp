@@ -0,0 +1,111 @@
+/**
+ * @file collision_test.cpp
+ *
+ * @brief parallel collision detection gives the same game as single-threaded detection
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include "autopilot.hpp"
+#include "check.hpp"
+#include "headless.hpp"
+
+////////////////////////////////TEST SETTINGS///////////////////////////////////
+constexpr float         test_aggression     = 1.f;
+constexpr std::uint32_t test_seed           = 1;
+//simulated time of both games, 20 s
+constexpr std::uint64_t test_ticks          = static_cast<std::uint64_t>(si::StressGame::tickrate)*20;
+//autopilot alone keeps less than one chunk of shells alive, extra shells are added
+//to split detection into chunks of all workers
+constexpr std::uint64_t test_shower_period  = si::StressGame::tickrate/2;
+constexpr int           test_shower_shells  = 150;
+//background threads of parallel game, independent of machine
+constexpr std::size_t   test_threads        = 3;
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief add visible shells at random positions, both games get the same shells
+static void addShower(si::StressGame& game, std::uint32_t seed)
+{
+    std::minstd_rand randomizer(seed);
+    std::uniform_real_distribution<float> x(si::default_start_x,si::default_x_size);
+    std::uniform_real_distribution<float> y(si::default_start_y,si::default_y_size);
+    for(auto i = 0; i < test_shower_shells; ++i)
+    {
+        Shell shell(game.bullets[0]);
+        shell.setShellType((i % 2 == 0) ? ShellType::Player : ShellType::Enemy);
+        shell.setPosition(sf::Vector2f(x(randomizer),y(randomizer)));
+        shell.setVisibility(true);
+        game.bullets.push_back(shell);
+    }
+    game.rebuildLiveLists();
+}
+
+template<class Items>
+static void checkItems(const Items& serial, const Items& parallel)
+{
+    CHECK(serial.size() == parallel.size());
+    for(std::size_t i = 0; i < serial.size(); ++i)
+    {
+        CHECK(serial[i].isVisible() == parallel[i].isVisible());
+        CHECK(serial[i].getPosition() == parallel[i].getPosition());
+    }
+}
+
+static void checkSameGame(const si::StressGame& serial, const si::StressGame& parallel)
+{
+    CHECK(serial.status == parallel.status);
+    CHECK(serial.elements.score == parallel.elements.score);
+    CHECK(serial.elements.player_lives == parallel.elements.player_lives);
+    CHECK(serial.getInvadersLeft() == parallel.getInvadersLeft());
+    CHECK(serial.player->getPosition() == parallel.player->getPosition());
+    CHECK(serial.invader_ship->isVisible() == parallel.invader_ship->isVisible());
+    checkItems(serial.enemies,parallel.enemies);
+    checkItems(serial.bullets,parallel.bullets);
+    checkItems(serial.obstacles,parallel.obstacles);
+}
+
+int main()
+{
+    si::StressGame serial;
+    si::StressGame parallel;
+    si::setupHeadlessItems(serial);
+    si::setupHeadlessItems(parallel);
+    serial.setSeed(test_seed);
+    parallel.setSeed(test_seed);
+    //every detection runs on thread pool
+    parallel.setParallelThreshold(0,test_threads);
+    si::Autopilot serial_pilot(test_aggression);
+    si::Autopilot parallel_pilot(test_aggression);
+
+    std::uint64_t hits = 0;
+    std::size_t peak_shells = 0;
+    for(std::uint64_t tick = 0; tick < test_ticks; ++tick)
+    {
+        serial_pilot.drive(serial);
+        parallel_pilot.drive(parallel);
+        if((serial.status == si::GameStatus::Running) && (tick % test_shower_period == 0))
+        {
+            addShower(serial,static_cast<std::uint32_t>(tick));
+            addShower(parallel,static_cast<std::uint32_t>(tick));
+        }
+        if(serial.status == si::GameStatus::Running){serial.gameLoop();}
+        if(parallel.status == si::GameStatus::Running){parallel.gameLoop();}
+        serial.events.drain([&](const si::GameEvent& event)
+        {
+            if(event.type != si::GameEventType::Shot){++hits;}
+        });
+        parallel.events.drain([](const si::GameEvent&){});
+        serial.arena.reset();
+        parallel.arena.reset();
+        peak_shells = std::max(peak_shells,serial.getLiveShells().size());
+        checkSameGame(serial,parallel);
+    }
+    //contacts were resolved and detection was split into several chunks
+    CHECK(hits > 0);
+    CHECK(peak_shells > si::collision_grain*(test_threads + 1));
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file governor_test.cpp
+ *
+ * @brief frame governor sheds, restores or holds quality level once per window of synthetic frames
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include "check.hpp"
+#include "governor.hpp"
+
+////////////////////////////////TEST SETTINGS///////////////////////////////////
+constexpr unsigned int test_framerate = 60;
+//frame times around budget of 16.7 ms
+constexpr auto test_fast_frame = std::chrono::milliseconds(1);
+constexpr auto test_slow_frame = std::chrono::milliseconds(30);
+//under budget but over restore ratio of budget
+constexpr auto test_busy_frame = std::chrono::milliseconds(12);
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief feed one decision window, first frames are slow and the others have given time
+static void feedWindow(FrameGovernor& governor, int slow_frames, FrameGovernor::clock::duration other)
+{
+    for(auto i = 0; i < governor_window; ++i)
+    {
+        governor.recordFrame((i < slow_frames) ? FrameGovernor::clock::duration(test_slow_frame) : other);
+    }
+}
+
+/// @brief check level after window and decision in the last log line
+static void checkDecision(const FrameGovernor& governor, std::istream& log, int level, const std::string& decision)
+{
+    CHECK(governor.getLevel() == level);
+    std::string line;
+    CHECK(std::getline(log,line));
+    CHECK(line.find(", " + decision + " level ") != std::string::npos);
+    //only one line per window
+    CHECK(log.peek() == std::char_traits<char>::eof());
+    log.clear();
+}
+
+int main()
+{
+    std::stringstream log;
+    FrameGovernor governor(test_framerate,&log);
+    const FrameGovernor::clock::duration fast = test_fast_frame;
+    const FrameGovernor::clock::duration busy = test_busy_frame;
+
+    //full quality is held while frames are fast
+    feedWindow(governor,0,fast);
+    checkDecision(governor,log,0,"hold");
+    CHECK(governor.getParticleDensity() == 1.f);
+    CHECK(governor.getHudRefreshPeriod() == 1);
+
+    //level is changed only at the end of window
+    for(auto i = 0; i < governor_window - 1; ++i){governor.recordFrame(test_slow_frame);}
+    CHECK(governor.getLevel() == 0);
+    CHECK(log.str().find("shed") == std::string::npos);
+    governor.recordFrame(test_slow_frame);
+    checkDecision(governor,log,1,"shed");
+
+    //one frame less than shed limit keeps level, worst frame prevents restore
+    feedWindow(governor,governor_shed_frames - 1,fast);
+    checkDecision(governor,log,1,"hold");
+    //frames under budget but over restore ratio keep level too
+    feedWindow(governor,0,busy);
+    checkDecision(governor,log,1,"hold");
+    //shed limit reached
+    feedWindow(governor,governor_shed_frames,fast);
+    checkDecision(governor,log,2,"shed");
+
+    //shedding stops at the last level
+    feedWindow(governor,governor_window,fast);
+    checkDecision(governor,log,3,"shed");
+    CHECK(governor.getParticleDensity() == 0.f);
+    CHECK(governor.getHudRefreshPeriod() == governor_hud_period);
+    feedWindow(governor,governor_window,fast);
+    checkDecision(governor,log,3,"hold");
+
+    //fast windows restore one level per window down to full quality
+    for(auto level = governor_levels - 2; level >= 0; --level)
+    {
+        feedWindow(governor,0,fast);
+        checkDecision(governor,log,level,"restore");
+    }
+    feedWindow(governor,0,fast);
+    checkDecision(governor,log,0,"hold");
+    CHECK(governor.getParticleDensity() == 1.f);
+
+    //3 sheds and 3 restores
+    std::ostringstream statistics;
+    governor.printStatistics(statistics);
+    CHECK(statistics.str().find("6 level changes") != std::string::npos);
+
+    //governor without log decides the same way
+    FrameGovernor silent(test_framerate);
+    feedWindow(silent,governor_window,fast);
+    CHECK(silent.getLevel() == 1);
+    return 0;
+}
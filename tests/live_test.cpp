@@ -0,0 +1,92 @@
+/**
+ * @file live_test.cpp
+ *
+ * @brief live lists of the game follow visibility of items through kills, wave respawn and restart
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <cstdint>
+#include "autopilot.hpp"
+#include "check.hpp"
+#include "headless.hpp"
+
+////////////////////////////////TEST SETTINGS///////////////////////////////////
+//autopilot fires at nearest invader and dodges some enemy shells
+constexpr float         test_aggression = 0.5f;
+constexpr std::uint32_t test_seed       = 1;
+//test fails if wave respawn and restart are not seen during this time, 10 simulated minutes
+constexpr std::uint64_t test_max_ticks  = static_cast<std::uint64_t>(si::Game::tickrate)*60*10;
+////////////////////////////////////////////////////////////////////////////////
+
+template<class Items>
+static void checkList(const Items& items, const si::LiveIndex& list)
+{
+    CHECK(list.capacity() == items.size());
+    std::size_t visible = 0;
+    for(std::size_t i = 0; i < items.size(); ++i)
+    {
+        CHECK(items[i].isVisible() == list.isLive(static_cast<std::uint32_t>(i)));
+        if(items[i].isVisible()){++visible;}
+    }
+    CHECK(list.size() == visible);
+}
+
+static void checkLiveLists(const si::Game& game)
+{
+    CHECK(game.getInvadersLeft() == game.getLiveInvaders().size());
+    checkList(game.enemies,game.getLiveInvaders());
+    checkList(game.bullets,game.getLiveShells());
+    checkList(game.obstacles,game.getLiveObstacles());
+}
+
+int main()
+{
+    si::Game game;
+    si::setupHeadlessItems(game);
+    game.setSeed(test_seed);
+    si::Autopilot autopilot(test_aggression);
+    //fresh game has no live items until first spawn
+    checkLiveLists(game);
+
+    std::uint64_t spawns   = 0;
+    std::uint64_t kills    = 0;
+    std::uint64_t respawns = 0;
+    std::uint64_t restarts = 0;
+    bool game_over         = false;
+    for(std::uint64_t tick = 0; (tick < test_max_ticks) && ((respawns == 0) || (restarts == 0)); ++tick)
+    {
+        const si::GameStatus status = game.status;
+        if(status == si::GameStatus::GameOver){game_over = true;}
+        const std::uint32_t invaders_left = game.getInvadersLeft();
+        //autopilot goes through game over and start screens with space key
+        autopilot.drive(game);
+        if(game.status == si::GameStatus::Running)
+        {
+            if(status == si::GameStatus::NotStarted)
+            {
+                if(game_over){++restarts;}
+                else{++spawns;}
+                game_over = false;
+            }
+            else
+            {
+                game.gameLoop();
+                if(game.getInvadersLeft() < invaders_left){kills += invaders_left - game.getInvadersLeft();}
+                //next wave is spawned by timer after the last invader is killed
+                else if((invaders_left == 0) && (game.getInvadersLeft() == game.enemies.size())){++respawns;}
+            }
+        }
+        game.events.drain([](const si::GameEvent&){});
+        game.arena.reset();
+        checkLiveLists(game);
+        //player is kept alive until first wave is cleared, then the game is lost and restarted
+        if((respawns == 0) && (game.elements.player_lives == 1)){game.elements.player_lives = si::default_num_of_lives;}
+    }
+    CHECK(spawns == 1);
+    CHECK(kills >= game.enemies.size());
+    CHECK(respawns > 0);
+    CHECK(restarts > 0);
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file music_test.cpp
+ *
+ * @brief music stream crossfades tracks of game screens, decodes only a bounded amount ahead
+ * of output and does not allocate after start
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "alloc.hpp"
+#include "check.hpp"
+#include "music.hpp"
+
+////////////////////////////////TEST SETTINGS///////////////////////////////////
+constexpr unsigned int  test_sample_rate     = 22050;
+//welcome track is shorter than one decoded block and loops many times
+constexpr std::uint64_t test_short_frames    = 1000;
+//other tracks are 10 minutes long, decoder shall never read far ahead of output
+constexpr std::uint64_t test_long_frames     = static_cast<std::uint64_t>(test_sample_rate)*60*10;
+//frames of one crossfade
+constexpr std::uint64_t test_fade_frames     = static_cast<std::uint64_t>(si::music_crossfade_s*test_sample_rate);
+//allowed difference of fade length, gain is accumulated in float
+constexpr std::uint64_t test_fade_tolerance  = test_fade_frames/50;
+//allowed step back of output during fade, one for every voice
+constexpr std::int32_t  test_truncation      = 2;
+//test fails if expected output is not seen during this number of frames
+constexpr std::uint64_t test_max_frames      = static_cast<std::uint64_t>(test_sample_rate)*10;
+//ticks of real time playback with null output
+constexpr unsigned int  test_playback_ticks  = 90;
+constexpr unsigned int  test_tickrate        = 60;
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief track of constant samples, counts decoded frames
+class ConstantSource : public si::MusicSource
+{
+    public:
+        ConstantSource(std::int16_t left, std::int16_t right, unsigned int channels, std::uint64_t length):
+            left(left), right(right), channels(channels), length(length) {}
+        std::size_t read(std::int16_t* samples, std::size_t count) override
+        {
+            const auto frames = std::min<std::uint64_t>(count/channels,length - position);
+            for(std::uint64_t frame = 0; frame < frames; ++frame)
+            {
+                samples[frame*channels]                = left;
+                samples[frame*channels + channels - 1] = right;
+            }
+            position += frames;
+            decoded.fetch_add(frames,std::memory_order_relaxed);
+            return static_cast<std::size_t>(frames*channels);
+        }
+        void rewind() override {position = 0;}
+        unsigned int getChannelCount() const override {return channels;}
+        unsigned int getSampleRate() const override {return test_sample_rate;}
+        /// @brief get number of frames read by decode thread
+        std::uint64_t getDecoded() const {return decoded.load(std::memory_order_relaxed);}
+
+    private:
+        std::int16_t left;
+        std::int16_t right;
+        unsigned int channels;
+        std::uint64_t length;
+        std::uint64_t position = 0;
+        std::atomic<std::uint64_t> decoded{0};
+};
+
+struct Frame
+{
+    std::int32_t left  = 0;
+    std::int32_t right = 0;
+    bool operator==(const Frame& other) const {return (left == other.left) && (right == other.right);}
+    bool operator!=(const Frame& other) const {return !(*this == other);}
+};
+
+/// @brief reads every mixed frame in order, incomplete reads are dropped and repeated
+class FrameReader
+{
+    public:
+        explicit FrameReader(si::MusicStream& stream): stream(stream) {}
+        Frame next()
+        {
+            std::int16_t samples[si::music_channels];
+            //decoder writes whole blocks, so a frame is either ready or the read is an underrun
+            auto underruns = stream.getUnderruns();
+            stream.read(samples,si::music_channels);
+            while(stream.getUnderruns() != underruns)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                underruns = stream.getUnderruns();
+                stream.read(samples,si::music_channels);
+            }
+            ++frames;
+            return Frame{samples[0],samples[1]};
+        }
+        std::uint64_t getFrames() const {return frames;}
+
+    private:
+        si::MusicStream& stream;
+        std::uint64_t frames = 0;
+};
+
+struct Fade
+{
+    /// @brief frames read after track request until output left start level
+    std::uint64_t delay = 0;
+    /// @brief frames between start and target levels
+    std::uint64_t length = 0;
+};
+
+/// @brief read frames until output leaves the start level and reaches the target level,
+/// called right after track request
+static Fade measureFade(FrameReader& reader, Frame start, Frame target)
+{
+    Fade result;
+    Frame frame = reader.next();
+    for(; (frame == start) && (result.delay < test_max_frames); ++result.delay){frame = reader.next();}
+    CHECK(frame != start);
+    std::uint64_t fade = 1;
+    Frame previous = start;
+    while((frame != target) && (fade < test_max_frames))
+    {
+        //gain of both voices changes linearly, so output moves towards target, every voice
+        //is truncated separately
+        CHECK(std::abs(target.left - frame.left) <= std::abs(target.left - previous.left) + test_truncation);
+        CHECK(std::abs(target.right - frame.right) <= std::abs(target.right - previous.right) + test_truncation);
+        previous = frame;
+        frame    = reader.next();
+        ++fade;
+    }
+    CHECK(frame == target);
+    //output stays at target level
+    for(std::uint64_t i = 0; i < test_fade_frames/4; ++i){CHECK(reader.next() == target);}
+    result.length = fade;
+    return result;
+}
+
+static void checkFade(const si::MusicStream& stream, const Fade& fade)
+{
+    //old track is heard only until buffered samples and the block being mixed are played
+    CHECK(fade.delay <= (stream.getRingCapacity() + si::music_block_samples)/si::music_channels);
+    CHECK(fade.length + test_fade_tolerance >= test_fade_frames);
+    CHECK(fade.length <= test_fade_frames + test_fade_tolerance);
+}
+
+int main()
+{
+    si::MusicSources sources;
+    sources[static_cast<std::size_t>(si::MusicTrack::Welcome)]  = std::make_unique<ConstantSource>(1000,1000,1,test_short_frames);
+    sources[static_cast<std::size_t>(si::MusicTrack::Game)]     = std::make_unique<ConstantSource>(2000,2000,1,test_long_frames);
+    sources[static_cast<std::size_t>(si::MusicTrack::GameOver)] = std::make_unique<ConstantSource>(4000,-4000,2,test_long_frames);
+    const auto& game_source = static_cast<const ConstantSource&>(*sources[static_cast<std::size_t>(si::MusicTrack::Game)]);
+
+    si::MusicStream stream(std::move(sources));
+    CHECK(stream.getSampleRate() == test_sample_rate);
+    //ring holds a fraction of second whatever the sample rate is
+    const auto ring_s = static_cast<float>(stream.getRingCapacity()/si::music_channels)/test_sample_rate;
+    CHECK((ring_s <= si::music_ring_s) && (ring_s > si::music_ring_s/2.f));
+    FrameReader reader(stream);
+
+    //welcome screen fades in from silence, short track loops without gaps
+    stream.setTrack(si::getMusicTrack(si::GameStatus::NotStarted));
+    checkFade(stream,measureFade(reader,Frame{0,0},Frame{1000,1000}));
+    for(std::uint64_t i = 0; i < 3*test_short_frames; ++i){CHECK(reader.next() == (Frame{1000,1000}));}
+
+    //game start crossfades welcome track into game track
+    stream.setTrack(si::getMusicTrack(si::GameStatus::Running));
+    checkFade(stream,measureFade(reader,Frame{1000,1000},Frame{2000,2000}));
+
+    //game over crossfades mono game track into stereo game over track
+    stream.setTrack(si::getMusicTrack(si::GameStatus::GameOver));
+    checkFade(stream,measureFade(reader,Frame{2000,2000},Frame{4000,-4000}));
+
+    //decoder stays at most one ring ahead of output, whatever the track length
+    CHECK(game_source.getDecoded() <= reader.getFrames() + stream.getRingCapacity()/si::music_channels);
+
+    //real time playback through null output switches tracks like the game loop, without
+    //underruns and without allocations in decode thread
+    const auto baseline_underruns = stream.getUnderruns();
+    const auto baseline           = si::getAllocations();
+    si::NullMusicOutput output(stream);
+    const si::GameStatus statuses[] = {si::GameStatus::NotStarted, si::GameStatus::Running, si::GameStatus::GameOver};
+    for(unsigned int tick = 0; tick < test_playback_ticks; ++tick)
+    {
+        stream.setTrack(si::getMusicTrack(statuses[(tick/(test_playback_ticks/3)) % 3]));
+        output.consume(1.f/test_tickrate);
+        std::this_thread::sleep_for(std::chrono::microseconds(1000000/test_tickrate));
+    }
+    CHECK(output.getConsumed() + si::music_channels >= std::uint64_t(test_playback_ticks)*test_sample_rate/test_tickrate*si::music_channels);
+    CHECK(stream.getUnderruns() == baseline_underruns);
+    const auto allocations = si::getAllocationsSince(baseline)[static_cast<std::size_t>(si::AllocationStage::Music)];
+    CHECK(allocations.count == 0);
+    CHECK(game_source.getDecoded() <= reader.getFrames() + output.getConsumed()/si::music_channels + stream.getRingCapacity()/si::music_channels);
+
+    //closed game fades music out
+    stream.setTrack(si::getMusicTrack(si::GameStatus::Closed));
+    FrameReader closing(stream);
+    for(std::uint64_t i = 0; (closing.next() != Frame{0,0}) && (i < test_max_frames); ++i){}
+    CHECK(closing.next() == (Frame{0,0}));
+    return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file network_test.cpp
+ *
+ * @brief snapshot encoding round trips and server with client on localhost
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "autopilot.hpp"
+#include "check.hpp"
+#include "headless.hpp"
+#include "network.hpp"
+
+////////////////////////////////TEST SETTINGS///////////////////////////////////
+//port of test server, differs from default one to run next to the game
+constexpr unsigned short test_port   = si::default_server_port + 7;
+//server ticks of localhost test, about 3 s
+constexpr std::uint64_t  test_ticks  = 180;
+//ticks between baseline and actual snapshot in encoding test
+constexpr int            delta_ticks = 10;
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief compare snapshots as client sees them, position of invisible entity is not sent
+static bool sameSnapshot(const si::Snapshot& a, const si::Snapshot& b)
+{
+    if((a.id != b.id) || (a.status != b.status) || (a.score != b.score) || (a.player_lives != b.player_lives)){return false;}
+    if(a.entities.size() != b.entities.size()){return false;}
+    for(std::size_t i = 0; i < a.entities.size(); ++i)
+    {
+        const si::EntityState& state_a = a.entities[i];
+        const si::EntityState& state_b = b.entities[i];
+        if(state_a.visible != state_b.visible){return false;}
+        if(state_a.visible && ((state_a.x != state_b.x) || (state_a.y != state_b.y))){return false;}
+    }
+    return true;
+}
+
+/// @brief encode snapshot, decode it back and return packet size
+static std::size_t roundTrip(const si::Snapshot& snapshot, const si::Snapshot* baseline, const si::SnapshotHistory& history, si::Snapshot& decoded)
+{
+    sf::Packet packet;
+    si::encodeSnapshot(snapshot,baseline,packet);
+    std::uint8_t type = 0;
+    packet>>type;
+    CHECK(type == static_cast<std::uint8_t>(si::MessageType::Snapshot));
+    CHECK(si::decodeSnapshot(packet,history,decoded));
+    return packet.getDataSize();
+}
+
+static void testEncoding()
+{
+    si::Game game;
+    si::setupHeadlessItems(game);
+    game.setSeed(1);
+    si::Autopilot autopilot(1.f);
+    auto run = [&](int ticks)
+    {
+        for(int tick = 0; tick < ticks; ++tick)
+        {
+            autopilot.drive(game);
+            if(game.status == si::GameStatus::Running){game.gameLoop();}
+            game.events.drain([](const si::GameEvent&){});
+            game.arena.reset();
+        }
+    };
+    run(300);
+    si::SnapshotHistory history;
+    si::Snapshot& baseline = history.insert(1);
+    si::captureSnapshot(game,baseline);
+    baseline.id = 1;
+    run(delta_ticks);
+    si::Snapshot actual;
+    si::captureSnapshot(game,actual);
+    actual.id = 2;
+
+    si::Snapshot decoded;
+    const auto full_size = roundTrip(actual,nullptr,history,decoded);
+    CHECK(sameSnapshot(actual,decoded));
+    const auto delta_size = roundTrip(actual,&baseline,history,decoded);
+    CHECK(sameSnapshot(actual,decoded));
+    CHECK(delta_size < full_size);
+
+    //delta against snapshot that receiver does not have is rejected
+    sf::Packet packet;
+    si::encodeSnapshot(actual,&baseline,packet);
+    std::uint8_t type = 0;
+    packet>>type;
+    CHECK(!si::decodeSnapshot(packet,si::SnapshotHistory(),decoded));
+}
+
+static void testLocalhost()
+{
+    si::Server server(test_port);
+    std::atomic<bool> finished{false};
+    std::thread thread([&]
+    {
+        server.run(test_ticks);
+        finished.store(true);
+    });
+    {
+        si::Client client(sf::IpAddress::LocalHost,test_port);
+        si::Game game;
+        //space press starts the game on server
+        sf::Event event{};
+        event.type     = sf::Event::KeyPressed;
+        event.key.code = sf::Keyboard::Key::Space;
+        client.handleEvent(event);
+        while(!finished.load())
+        {
+            client.update(game);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        //client sees the game started by its own input
+        CHECK(game.status == si::GameStatus::Running);
+        CHECK(client.getAckedSnapshot() > test_ticks/2);
+    }
+    thread.join();
+    const si::ServerStatistics& statistics = server.getStatistics();
+    CHECK(statistics.clients == 1);
+    CHECK(statistics.snapshots > test_ticks/2);
+    //client acknowledges snapshots, so almost all of them are deltas
+    CHECK(statistics.delta_snapshots*10 >= statistics.snapshots*9);
+    CHECK(statistics.bytes_per_tick > 0);
+    CHECK(statistics.bytes_per_tick == statistics.bytes_per_tick_client);
+
+    //deltas are smaller than full snapshot of the same game
+    si::Game game;
+    si::Snapshot snapshot;
+    si::captureSnapshot(game,snapshot);
+    sf::Packet packet;
+    si::encodeSnapshot(snapshot,nullptr,packet);
+    CHECK(statistics.bytes_per_tick < packet.getDataSize());
+}
+
+int main()
+{
+    testEncoding();
+    testLocalhost();
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file render_test.cpp
+ *
+ * @brief render queue order and batching statistics of render backend
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <array>
+#include <functional>
+#include <vector>
+#include "check.hpp"
+#include "render.hpp"
+
+/// @brief recording backend that also keeps size of every quad batch
+class BatchRecorder : public si::RecordingBackend
+{
+    public:
+        /// @brief get number of vertices of every quad batch of last frame
+        const std::vector<std::size_t>& getBatches() const {return batches;}
+
+    protected:
+        void drawQuads(const sf::Vertex*, std::size_t count, const sf::Texture*) override {batches.push_back(count);}
+        void beginFrame(const si::RenderQueue& queue) override
+        {
+            batches.clear();
+            si::RecordingBackend::beginFrame(queue);
+        }
+
+    private:
+        std::vector<std::size_t> batches;
+};
+
+static void testSortedFrame()
+{
+    std::array<sf::Texture,3> textures;
+    sf::Sprite first(textures[0]);
+    sf::Sprite second(textures[1]);
+    sf::Sprite ship(textures[2]);
+    sf::Text text;
+    sf::VertexArray debris(sf::Quads,4);
+    si::RenderQueue queue;
+    queue.add(si::RenderLayer::Ships,ship);
+    queue.add(si::RenderLayer::Items,second);
+    queue.add(si::RenderLayer::Items,first);
+    queue.add(si::RenderLayer::Menu,text);
+    queue.add(si::RenderLayer::Items,second);
+    queue.add(si::RenderLayer::Ships,ship);
+    queue.add(si::RenderLayer::Items,first);
+    queue.add(si::RenderLayer::Effects,debris);
+    queue.sort();
+
+    //layer first, then texture address, then insertion order
+    const bool first_is_lower = std::less<const sf::Texture*>()(&textures[0],&textures[1]);
+    const std::vector<std::uint32_t> items_order = first_is_lower ? std::vector<std::uint32_t>{2,6,1,4} : std::vector<std::uint32_t>{1,4,2,6};
+    std::vector<std::uint32_t> expected{3};
+    expected.insert(expected.end(),items_order.begin(),items_order.end());
+    expected.insert(expected.end(),{7,0,5});
+
+    BatchRecorder backend;
+    backend.submit(queue);
+    const std::vector<si::RenderCommand>& frame = backend.getFrame();
+    CHECK(frame.size() == expected.size());
+    for(std::size_t i = 0; i < frame.size(); ++i){CHECK(frame[i].sequence == expected[i]);}
+    for(std::size_t i = 1; i < frame.size(); ++i){CHECK(frame[i - 1].layer <= frame[i].layer);}
+    CHECK(frame[0].drawable == &text);
+    CHECK(frame[5].drawable == &debris);
+
+    //text, two item batches, debris and ship batch
+    const si::RenderStatistics& statistics = backend.getStatistics();
+    CHECK(statistics.commands == 8);
+    CHECK(statistics.draw_calls == 5);
+    CHECK(statistics.texture_changes == 2);
+    CHECK((backend.getBatches() == std::vector<std::size_t>{8,8,8}));
+}
+
+static void testSingleBatch()
+{
+    sf::Texture texture;
+    std::array<sf::Sprite,16> sprites;
+    si::RenderQueue queue;
+    for(sf::Sprite& sprite : sprites)
+    {
+        sprite.setTexture(texture);
+        queue.add(si::RenderLayer::Items,sprite);
+    }
+    queue.sort();
+    BatchRecorder backend;
+    //statistics are reset on every submission
+    backend.submit(queue);
+    backend.submit(queue);
+    const si::RenderStatistics& statistics = backend.getStatistics();
+    CHECK(statistics.commands == sprites.size());
+    CHECK(statistics.draw_calls == 1);
+    CHECK(statistics.texture_changes == 0);
+    CHECK((backend.getBatches() == std::vector<std::size_t>{sprites.size()*4}));
+
+    //empty frame draws nothing
+    queue.clear();
+    backend.submit(queue);
+    CHECK(backend.getFrame().empty());
+    CHECK(backend.getStatistics().draw_calls == 0);
+    CHECK(backend.getBatches().empty());
+}
+
+int main()
+{
+    testSortedFrame();
+    testSingleBatch();
+    return 0;
+}
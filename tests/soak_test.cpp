@@ -0,0 +1,45 @@
+/**
+ * @file soak_test.cpp
+ *
+ * @brief autopilot session does not allocate after warm-up, report lines included,
+ * allocation check runs only in builds with SI_ALLOCATION_TRACKING
+ *
+ * @author Siarhei Tatarchanka
+ *
+ */
+
+#include <cstdint>
+#include <iostream>
+#include "alloc.hpp"
+#include "autopilot.hpp"
+#include "check.hpp"
+
+////////////////////////////////TEST SETTINGS///////////////////////////////////
+//warm-up fills shell storage, arena and live lists, 20 simulated seconds
+constexpr std::uint64_t test_warmup = static_cast<std::uint64_t>(si::Game::tickrate)*20;
+//session ends one second after first report line, so the tick after the report is checked too
+constexpr std::uint64_t test_ticks  = static_cast<std::uint64_t>(si::Game::tickrate)*(si::soak_report_period_s + 1);
+////////////////////////////////////////////////////////////////////////////////
+
+static void runSession(si::GameVariant variant)
+{
+    si::SoakOptions options;
+    options.variant           = variant;
+    options.ticks             = test_ticks;
+    options.aggression        = 0.5f;
+    options.seed              = 1;
+    options.allocation_warmup = si::allocation_tracking ? test_warmup : 0;
+    //report lines go to the same stream as in the game, string stream would allocate
+    CHECK(si::runSoak(options,std::cout));
+}
+
+int main()
+{
+    if(!si::allocation_tracking)
+    {
+        std::cout<<"soak test: allocation check is skipped, build with SI_ALLOCATION_TRACKING\n";
+    }
+    runSession(si::GameVariant::Classic);
+    runSession(si::GameVariant::Stress);
+    return 0;
+}